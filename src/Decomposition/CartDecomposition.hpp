@@ -186,6 +186,9 @@ protected:
 	//! exist for efficient global communication
 	CellList<dim,T,Mem_fast<Memory,int>,shift<dim,T>> fine_s;
 
+	//! Temporal buffer to return the result of ghost_processorID_global
+	openfpm::vector<std::pair<size_t,size_t>> ids_g;
+
 	//! Structure that store the cartesian grid information
 	grid_sm<dim, void> gr;
 
@@ -1167,6 +1170,97 @@ public:
 		return processorID_impl(pt,fine_s,sub_domains_global,getDomain(),bc);
 	}
 
+	/*! \brief Given a point it return the processors that has such point in the ghost part
+	 *
+	 * Unlike ghost_processorID_pair, that use the internal ghost boxes and so can label only points
+	 * inside the local sub-domains, this function use the global set of sub-domains and can label
+	 * any point of the domain. It is used to label the ghost of a particle that is migrating to another processor.
+	 * Periodic images of the point that fall on the owner are not returned, the owner create them locally
+	 *
+	 * \param p point (already inside the domain)
+	 * \param owner processor that own the point
+	 *
+	 * \return a vector of pair containing the processor (rank) and the shift id
+	 *
+	 */
+	const openfpm::vector<std::pair<size_t,size_t>> & ghost_processorID_global(const Point<dim,T> & p, size_t owner)
+	{
+		ids_g.clear();
+
+		const openfpm::vector<Point<dim,T>,Memory,layout_base> & shifts = this->getShiftVectors();
+		auto & gi = fine_s.getGrid();
+
+		// For each periodic image of the point
+		for (size_t s = 0 ; s < openfpm::math::pow(3,dim) ; s++)
+		{
+			comb<dim> cmb;
+			size_t lin = s;
+			bool valid = true;
+
+			for (size_t k = 0 ; k < dim ; k++)
+			{
+				cmb.c[k] = (char)(lin % 3) - 1;
+				lin /= 3;
+
+				if (cmb.c[k] != 0 && bc[k] != PERIODIC)
+				{valid = false;}
+			}
+
+			if (valid == false)
+			{continue;}
+
+			size_t shift_id = this->convertShift(cmb);
+
+			Point<dim,T> img = p;
+			img -= shifts.get(shift_id);
+
+			// A sub-domain has img in its ghost only if it intersect this box
+			::Box<dim,T> bq;
+
+			for (size_t k = 0 ; k < dim ; k++)
+			{
+				bq.setLow(k,std::max(img.get(k) - ghost.getHigh(k),domain.getLow(k)));
+				bq.setHigh(k,std::min(img.get(k) - ghost.getLow(k),domain.getHigh(k)));
+
+				if (bq.getLow(k) > bq.getHigh(k))
+				{valid = false;}
+			}
+
+			if (valid == false)
+			{continue;}
+
+			grid_key_dx_iterator_sub<dim> g_sub(gi,fine_s.getCellGrid_me(bq.getP1()),fine_s.getCellGrid_pe(bq.getP2()));
+
+			while (g_sub.isNext())
+			{
+				size_t cl = gi.LinId(g_sub.get());
+
+				for (size_t i = 0 ; i < fine_s.getNelements(cl) ; i++)
+				{
+					size_t e = fine_s.get(cl,i);
+					size_t prc = sub_domains_global.template get<1>(e);
+
+					if (prc == owner)
+					{continue;}
+
+					::Box<dim,T> sub_g = sub_domains_global.template get<0>(e);
+					sub_g.enlarge(ghost);
+
+					if (sub_g.isInsideNP(img) == true)
+					{ids_g.add(std::pair<size_t,size_t>(prc,shift_id));}
+				}
+
+				++g_sub;
+			}
+		}
+
+		// the same processor can have several sub-domains containing the point
+		ids_g.sort();
+		ids_g.unique();
+
+		return ids_g;
+	}
+
 	/*! \brief Get the periodicity on i dimension
 	 *
 	 * \param i dimension
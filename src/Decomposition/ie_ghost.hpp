@@ -911,6 +911,38 @@ public:
 		return ghost_processorID_N_impl(p,geo_cell,vb_int_box,vb_int);
 	}
 
+	/*! \brief Given a cell-list it return the cells that intersect the internal ghost boxes (skin cells)
+	 *
+	 * Only the particles in these cells can be ghost of some near processor
+	 *
+	 * \param cl Cell-list (it must cover the local sub-domains)
+	 * \param cells list of the cells (ordered and unique)
+	 *
+	 */
+	template<typename CellL> void getInternalGhostCells(CellL & cl, openfpm::vector<size_t> & cells)
+	{
+		cells.clear();
+
+		auto & gi = cl.getGrid();
+
+		for (size_t i = 0 ; i < vb_int_box.size() ; i++)
+		{
+			Box<dim,T> bx = vb_int_box.get(i);
+
+			grid_key_dx_iterator_sub<dim> g_sub(gi,cl.getCellGrid_me(bx.getP1()),cl.getCellGrid_pe(bx.getP2()));
+
+			while (g_sub.isNext())
+			{
+				cells.add(gi.LinId(g_sub.get()));
+
+				++g_sub;
+			}
+		}
+
+		cells.sort();
+		cells.unique();
+	}
+
 	/*! \brief Given a position it return if the position belong to any neighborhood processor ghost
 	 * (Internal ghost)
 	 *
@@ -1053,6 +1085,47 @@ public:
 		return ids_p;
 	}
 
+	/*! \brief Given a position it return if the position belong to any neighborhood processor ghost
+	 * (Internal ghost)
+	 *
+	 * Same as the other ghost_processorID_pair, but the result is stored in a buffer given by the caller,
+	 * so it can be called concurrently by several threads
+	 *
+	 * \tparam id1 first index type to get box_id processor_id lc_processor_id
+	 * \tparam id2 second index type to get box_id processor_id lc_processor_id
+	 *
+	 * \param p Particle position
+	 * \param ids_out buffer where to store the pairs
+	 * \param opt indicate if the entries in the vector must be unique
+	 *
+	 */
+	template<typename id1, typename id2, typename Point_type> inline void ghost_processorID_pair(const Point_type & p,
+			                                                                                     openfpm::vector<std::pair<size_t,size_t>> & ids_out,
+			                                                                                     const int opt)
+	{
+		ids_out.clear();
+
+		auto cell_it = geo_cell.getCellIterator(geo_cell.getCell(p));
+
+		while (cell_it.isNext())
+		{
+			size_t bid = cell_it.get();
+
+			if (Box<dim,T>(vb_int_box.get(bid)).isInsideNP(p) == true)
+			{
+				ids_out.add(std::pair<size_t,size_t>(id1::id(vb_int.get(bid),bid),id2::id(vb_int.get(bid),bid)));
+			}
+
+			++cell_it;
+		}
+
+		if (opt == UNIQUE)
+		{
+			ids_out.sort();
+			ids_out.unique();
+		}
+	}
+
 	/*! \brief Given a position it return if the position belong to any neighborhood processor ghost
 	 * (Internal ghost)
 	 *
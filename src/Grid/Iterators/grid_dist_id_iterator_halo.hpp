@@ -0,0 +1,137 @@
+/*
+ * grid_dist_id_iterator_halo.hpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef GRID_DIST_ID_ITERATOR_HALO_HPP_
+#define GRID_DIST_ID_ITERATOR_HALO_HPP_
+
+#include "Grid/grid_dist_key.hpp"
+
+/*! \brief Distributed grid iterator that span for each local grid an arbitrary box
+ *
+ * It is used to iterate the domain extended by some layers of ghost (see grid_dist_id::getDomainHaloIterator)
+ *
+ * \tparam dim dimensionality of the grid
+ * \tparam device_grid type of basic grid
+ * \tparam device_sub_it sub-iterator type of the device_grid
+ *
+ */
+template<unsigned int dim, typename device_grid, typename device_sub_it>
+class grid_dist_iterator_halo
+{
+	//! grid list counter
+	size_t g_c;
+
+	//! List of the grids we are going to iterate
+	const openfpm::vector<device_grid> & gList;
+
+	//! For each local grid the box to iterate (in local coordinates)
+	openfpm::vector<Box<dim,long int>> bx;
+
+	//! Actual iterator
+	device_sub_it a_it;
+
+	/*! \brief from g_c increment g_c until you find a valid grid
+	 *
+	 */
+	void selectValidGrid()
+	{
+		do
+		{
+			// When the grid has size 0 potentially all the other informations are garbage
+			while (g_c < gList.size() && (gList.get(g_c).size() == 0 || bx.get(g_c).isValid() == false)) g_c++;
+
+			// get the next grid iterator
+			if (g_c < gList.size())
+			{
+				a_it.reinitialize(gList.get(g_c).getIterator(bx.get(g_c).getKP1(),bx.get(g_c).getKP2()));
+				if (a_it.isNext() == false)	{g_c++;}
+			}
+		} while (g_c < gList.size() && a_it.isNext() == false);
+	}
+
+	public:
+
+	/*! \brief Constructor of the distributed grid iterator
+	 *
+	 * \param gk std::vector of the local grid
+	 * \param bx for each local grid the box to iterate
+	 *
+	 */
+	grid_dist_iterator_halo(const openfpm::vector<device_grid> & gk,
+						    const openfpm::vector<Box<dim,long int>> & bx)
+	:g_c(0),gList(gk),bx(bx)
+	{
+		// Initialize the current iterator
+		// with the first grid
+		selectValidGrid();
+	}
+
+	//! Copy constructor
+	grid_dist_iterator_halo(const grid_dist_iterator_halo<dim,device_grid,device_sub_it> & g)
+	:g_c(g.g_c),gList(g.gList),bx(g.bx),a_it(g.a_it)
+	{}
+
+	/*! \brief Get the next element
+	 *
+	 * \return the next grid_key
+	 *
+	 */
+	inline grid_dist_iterator_halo<dim,device_grid,device_sub_it> & operator++()
+	{
+		++a_it;
+
+		// check if a_it is at the end
+
+		if (a_it.isNext() == true)
+			return *this;
+		else
+		{
+			// switch to the new grid
+			g_c++;
+
+			selectValidGrid();
+		}
+
+		return *this;
+	}
+
+	/*! \brief Check if there is the next element
+	 *
+	 * \return true if there is the next, false otherwise
+	 *
+	 */
+	inline bool isNext() const
+	{
+		// If there are no other grid stop
+
+		if (g_c >= gList.size())
+		{return false;}
+
+		return true;
+	}
+
+	/*! \brief Get the actual key
+	 *
+	 * \return the actual key
+	 *
+	 */
+	inline grid_dist_key_dx<dim, typename device_grid::base_key> get() const
+	{
+		return grid_dist_key_dx<dim,typename device_grid::base_key>(g_c,a_it.get());
+	}
+
+	/*! \brief Get the boxes iterated
+	 *
+	 * \return for each local grid the box iterated (in local coordinates)
+	 *
+	 */
+	inline const openfpm::vector<Box<dim,long int>> & getBoxes() const
+	{
+		return bx;
+	}
+};
+
+#endif /* GRID_DIST_ID_ITERATOR_HALO_HPP_ */
@@ -0,0 +1,340 @@
+/*
+ * grid_dist_ghost_dtype.hpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef SRC_GRID_GRID_DIST_GHOST_DTYPE_HPP_
+#define SRC_GRID_GRID_DIST_GHOST_DTYPE_HPP_
+
+#include <mpi.h>
+
+//! helper to detect if an expression is valid
+template<typename> struct ghost_dtype_void
+{
+	//! always void
+	typedef void type;
+};
+
+/*! \brief Indicate if the property p of device_grid is stored in memory and can be addressed directly
+ *
+ * \tparam device_grid local grid type
+ * \tparam dim dimensionality
+ * \tparam p property
+ *
+ */
+template<typename device_grid, unsigned int dim, int p, typename Sfinae = void>
+struct ghost_dtype_prp_addr
+{
+	//! by default not addressable
+	static const bool value = false;
+};
+
+/*! \brief Indicate if the property p of device_grid is stored in memory and can be addressed directly
+ *
+ * This is the case when get return a reference
+ *
+ */
+template<typename device_grid, unsigned int dim, int p>
+struct ghost_dtype_prp_addr<device_grid,dim,p,
+                            typename ghost_dtype_void<decltype(std::declval<device_grid &>().template get<p>(std::declval<const grid_key_dx<dim> &>()))>::type>
+{
+	//! true if get return a reference
+	static const bool value = std::is_lvalue_reference<decltype(std::declval<device_grid &>().template get<p>(std::declval<const grid_key_dx<dim> &>()))>::value;
+};
+
+/*! \brief Indicate if all the properties prp... of device_grid can be addressed directly
+ *
+ * \tparam device_grid local grid type
+ * \tparam dim dimensionality
+ * \tparam prp properties
+ *
+ */
+template<typename device_grid, unsigned int dim, int ... prp>
+struct ghost_dtype_addressable;
+
+//! Terminator of ghost_dtype_addressable
+template<typename device_grid, unsigned int dim>
+struct ghost_dtype_addressable<device_grid,dim>
+{
+	//! No property left
+	static const bool value = true;
+};
+
+//! Recursion of ghost_dtype_addressable
+template<typename device_grid, unsigned int dim, int p, int ... prp>
+struct ghost_dtype_addressable<device_grid,dim,p,prp...>
+{
+	//! true if p and all the following are addressable
+	static const bool value = ghost_dtype_prp_addr<device_grid,dim,p>::value && ghost_dtype_addressable<device_grid,dim,prp...>::value;
+};
+
+/*! \brief MPI datatype that select a box of one property of a dense grid
+ *
+ * The elements are seen as blocks of sz_prp bytes at a distance of stride bytes (so it work for interleaved
+ * and non interleaved layout), the first dimension is the fastest
+ *
+ * \param g grid information
+ * \param box box to select (in local grid coordinates)
+ * \param sz_prp size of the property
+ * \param stride distance in bytes between two consecutive elements
+ *
+ * \return the datatype (not committed), displacement zero is the element 0 of the property
+ *
+ */
+template<unsigned int dim>
+inline MPI_Datatype ghost_dtype_box(const grid_sm<dim,void> & g, const Box<dim,long int> & box, size_t sz_prp, size_t stride)
+{
+	MPI_Datatype el;
+	MPI_Datatype el_r;
+	MPI_Datatype sub;
+
+	MPI_Type_contiguous(sz_prp,MPI_BYTE,&el);
+	MPI_Type_create_resized(el,0,stride,&el_r);
+	MPI_Type_free(&el);
+
+	int sizes[dim];
+	int subsizes[dim];
+	int starts[dim];
+
+	for (size_t i = 0 ; i < dim ; i++)
+	{
+		sizes[i] = g.size(i);
+		subsizes[i] = box.getHigh(i) - box.getLow(i) + 1;
+		starts[i] = box.getLow(i);
+	}
+
+	MPI_Type_create_subarray(dim,sizes,subsizes,starts,MPI_ORDER_FORTRAN,el_r,&sub);
+	MPI_Type_free(&el_r);
+
+	return sub;
+}
+
+/*! \brief Datatypes of a ghost_get without packing
+ *
+ * For each near processor one datatype select all the internal ghost boxes to send and one all the
+ * external ghost boxes to receive, directly in the memory of the local grids. They are valid until the
+ * local grids are reallocated or the ghost boxes change, grid_dist_id_comm keep one for each set of properties
+ *
+ */
+struct ghost_dtype_cache
+{
+	//! for each processor (same order of ig_box) the datatype to send
+	openfpm::vector<MPI_Datatype> send;
+
+	//! for each processor (same order of eg_box) the datatype to receive
+	openfpm::vector<MPI_Datatype> recv;
+
+	//! address of the properties of each local grid when the datatypes has been created
+	std::vector<void *> base;
+
+	//! properties the datatypes has been created for
+	std::vector<int> prp;
+
+	//! requests of the communication in flight
+	openfpm::vector<MPI_Request> req;
+
+	//! true if the datatypes are valid
+	bool valid = false;
+
+	//! Constructor
+	ghost_dtype_cache()
+	{}
+
+	/*! \brief Copy constructor
+	 *
+	 * The datatypes are not copied, they are created again when needed
+	 *
+	 */
+	ghost_dtype_cache(const ghost_dtype_cache & gc)
+	{}
+
+	/*! \brief Copy operator
+	 *
+	 * The datatypes are not copied, they are created again when needed
+	 *
+	 * \return itself
+	 *
+	 */
+	ghost_dtype_cache & operator=(const ghost_dtype_cache & gc)
+	{
+		clear();
+		return *this;
+	}
+
+	//! Free the datatypes
+	void clear()
+	{
+		int finalized = 0;
+		MPI_Finalized(&finalized);
+
+		if (finalized == 0)
+		{
+			for (size_t i = 0 ; i < send.size() ; i++)
+			{
+				if (send.get(i) != MPI_DATATYPE_NULL)
+				{MPI_Type_free(&send.get(i));}
+			}
+
+			for (size_t i = 0 ; i < recv.size() ; i++)
+			{
+				if (recv.get(i) != MPI_DATATYPE_NULL)
+				{MPI_Type_free(&recv.get(i));}
+			}
+		}
+
+		send.clear();
+		recv.clear();
+		base.clear();
+		prp.clear();
+		valid = false;
+	}
+
+	//! Destructor
+	~ghost_dtype_cache()
+	{
+		clear();
+	}
+};
+
+/*! \brief Create the datatypes of a ghost_get without packing
+ *
+ * \tparam is_addressable true if the properties can be addressed directly, otherwise nothing is done
+ *
+ */
+template<bool is_addressable>
+struct ghost_dtype_impl
+{
+	//! not addressable, nothing to do
+	template<int ... prp, typename device_grid>
+	static void base(openfpm::vector<device_grid> & loc_grid, std::vector<void *> & bs)
+	{}
+
+	//! not addressable, nothing to do
+	template<int ... prp, unsigned int dim, typename device_grid>
+	static void add_box(device_grid & lg,
+						const Box<dim,long int> & box,
+						openfpm::vector<int> & bl,
+						openfpm::vector<MPI_Aint> & disp,
+						openfpm::vector<MPI_Datatype> & tp)
+	{}
+};
+
+/*! \brief Create the datatypes of a ghost_get without packing
+ *
+ */
+template<>
+struct ghost_dtype_impl<true>
+{
+	/*! \brief Get the address of the element 0 of each property of each local grid
+	 *
+	 * \tparam prp properties
+	 *
+	 * \param loc_grid local grids
+	 * \param bs output addresses
+	 *
+	 */
+	template<int ... prp, typename device_grid>
+	static void base(openfpm::vector<device_grid> & loc_grid, std::vector<void *> & bs)
+	{
+		bs.clear();
+
+		for (size_t i = 0 ; i < loc_grid.size() ; i++)
+		{
+			// an empty grid has no address
+			if (loc_grid.get(i).getGrid().size() == 0)
+			{
+				bs.push_back(NULL);
+				continue;
+			}
+
+			grid_key_dx<device_grid::dims> k0;
+			k0.zero();
+
+			void * adr[] = {(void *)&loc_grid.get(i).template get<prp>(k0)...,NULL};
+
+			for (size_t p = 0 ; p < sizeof...(prp) ; p++)
+			{bs.push_back(adr[p]);}
+		}
+	}
+
+	/*! \brief Add the datatypes that select the box of the local grid lg for the properties prp
+	 *
+	 * \tparam prp properties
+	 *
+	 * \param lg local grid
+	 * \param box box in local grid coordinates
+	 * \param bl block lengths
+	 * \param disp absolute displacements
+	 * \param tp datatypes
+	 *
+	 */
+	template<int ... prp, unsigned int dim, typename device_grid>
+	static void add_box(device_grid & lg,
+						const Box<dim,long int> & box,
+						openfpm::vector<int> & bl,
+						openfpm::vector<MPI_Aint> & disp,
+						openfpm::vector<MPI_Datatype> & tp)
+	{
+		auto & g = lg.getGrid();
+		size_t n = g.size();
+
+		if (n == 0 || box.isValid() == false)
+		{return;}
+
+		grid_key_dx<dim> k0;
+		grid_key_dx<dim> k1;
+		k0.zero();
+		for (size_t i = 0 ; i < dim ; i++)
+		{k1.set_d(i,g.size(i)-1);}
+
+		size_t sz_prp[] = {sizeof(typename std::remove_reference<decltype(lg.template get<prp>(k0))>::type)...,0};
+		char * adr0[] = {(char *)&lg.template get<prp>(k0)...,NULL};
+		char * adr1[] = {(char *)&lg.template get<prp>(k1)...,NULL};
+
+		for (size_t p = 0 ; p < sizeof...(prp) ; p++)
+		{
+			// the element n-1 is at (n-1)*stride from the element 0
+			size_t stride = (n > 1)?(adr1[p] - adr0[p]) / (n - 1):sz_prp[p];
+
+			MPI_Aint d;
+			MPI_Get_address(adr0[p],&d);
+
+			bl.add(1);
+			disp.add(d);
+			tp.add(ghost_dtype_box(g,box,sz_prp[p],stride));
+		}
+	}
+};
+
+/*! \brief Merge the datatypes in one datatype with absolute addresses (to use with MPI_BOTTOM)
+ *
+ * \param bl block lengths
+ * \param disp absolute displacements
+ * \param tp datatypes, they are freed
+ *
+ * \return the committed datatype, MPI_DATATYPE_NULL if there is nothing to select
+ *
+ */
+inline MPI_Datatype ghost_dtype_merge(openfpm::vector<int> & bl,
+									  openfpm::vector<MPI_Aint> & disp,
+									  openfpm::vector<MPI_Datatype> & tp)
+{
+	if (tp.size() == 0)
+	{return MPI_DATATYPE_NULL;}
+
+	MPI_Datatype res;
+	MPI_Type_create_struct(tp.size(),&bl.get(0),&disp.get(0),&tp.get(0),&res);
+	MPI_Type_commit(&res);
+
+	for (size_t i = 0 ; i < tp.size() ; i++)
+	{MPI_Type_free(&tp.get(i));}
+
+	bl.clear();
+	disp.clear();
+	tp.clear();
+
+	return res;
+}
+
+#endif /* SRC_GRID_GRID_DIST_GHOST_DTYPE_HPP_ */
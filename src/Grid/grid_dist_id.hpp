@@ -14,6 +14,7 @@
 #include "Iterators/grid_dist_id_iterator_dec.hpp"
 #include "Iterators/grid_dist_id_iterator.hpp"
 #include "Iterators/grid_dist_id_iterator_sub.hpp"
+#include "Iterators/grid_dist_id_iterator_halo.hpp"
 #include "grid_dist_key.hpp"
 #include "NN/CellList/CellDecomposer.hpp"
 #include "util/object_util.hpp"
@@ -1091,6 +1092,8 @@ protected:
 
 		init_local_e_g_box = false;
 		loc_eg_box.clear();
+
+		this->reset_ghost_plan();
 	}
 
 public:
@@ -1957,6 +1960,92 @@ public:
 		return it;
 	}
 
+	/*! \brief It return an iterator that span the domain extended by w layers of ghost
+	 *
+	 * For each local grid the domain is extended by w points in each direction, limited by the ghost
+	 * of the local grid and, in the non periodic directions, by the border of the grid
+	 *
+	 * \param w number of ghost layers
+	 *
+	 * \return the iterator
+	 *
+	 */
+	grid_dist_iterator_halo<dim,device_grid,decltype(device_grid::type_of_subiterator())>
+	getDomainHaloIterator(size_t w) const
+	{
+#ifdef SE_CLASS2
+		check_valid(this,8);
+#endif
+
+		openfpm::vector<Box<dim,long int>> bx(loc_grid.size());
+
+		for (size_t i = 0 ; i < loc_grid.size() ; i++)
+		{
+			const Box<dim,long int> & Dbox = gdb_ext.get(i).Dbox;
+			const Box<dim,long int> & GDbox = gdb_ext.get(i).GDbox;
+
+			bx.get(i) = Dbox;
+
+			// local grid without domain
+			if (Dbox.isValid() == false)
+			{continue;}
+
+			for (size_t d = 0 ; d < dim ; d++)
+			{
+				long int lo = Dbox.getLow(d) - (long int)w;
+				long int hi = Dbox.getHigh(d) + (long int)w;
+
+				// in the non periodic directions we do not go outside the grid
+				if (dec.periodicity(d) == NON_PERIODIC)
+				{
+					lo = std::max(lo,-gdb_ext.get(i).origin.get(d));
+					hi = std::min(hi,(long int)g_sz[d] - 1 - gdb_ext.get(i).origin.get(d));
+				}
+
+#ifdef SE_CLASS1
+
+				if (lo < GDbox.getLow(d) || hi > GDbox.getHigh(d))
+				{std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the ghost is smaller than the " << w << " layers requested" << std::endl;}
+
+#endif
+
+				bx.get(i).setLow(d,std::max(lo,GDbox.getLow(d)));
+				bx.get(i).setHigh(d,std::min(hi,GDbox.getHigh(d)));
+			}
+		}
+
+		return grid_dist_iterator_halo<dim,device_grid,decltype(device_grid::type_of_subiterator())>(loc_grid,bx);
+	}
+
+	/*! \brief It return the iterator of the sub-step m of a communication avoiding scheme
+	 *
+	 * With a stencil of radius s and a ghost of k*s points, one ghost_get serve k time steps.
+	 * The sub-step m (0 <= m < k) after the ghost_get update the domain and (k-1-m)*s layers of ghost, the
+	 * region updated shrink by s each sub-step, because the points at distance s from it are the only
+	 * one still valid. The redundant computation on the ghost replace k-1 ghost_get.
+	 *
+	 * \snippet grid_dist_id_unit_test.cpp communication avoiding stencil
+	 *
+	 * \param s radius of the stencil
+	 * \param k number of steps for each ghost_get (the ghost must be at least k*s)
+	 * \param m sub-step, if m >= k an error is printed and the iterator span only the domain
+	 *
+	 * \return the iterator
+	 *
+	 */
+	grid_dist_iterator_halo<dim,device_grid,decltype(device_grid::type_of_subiterator())>
+	getCommAvoidIterator(size_t s, size_t k, size_t m) const
+	{
+		// the last sub-step update only the domain, a bigger m would wrap the number of layers
+		if (m >= k)
+		{
+			std::cerr << "Error " << __FILE__ << ":" << __LINE__ << " the sub-step " << m << " must be smaller than " << k << std::endl;
+			return getDomainHaloIterator(0);
+		}
+
+		return getDomainHaloIterator((k-1-m)*s);
+	}
+
 	/*! \brief It return an iterator that span the grid domain only in the specified
 	 * part
 	 *
@@ -2366,6 +2455,74 @@ public:
 																								  opt);
 	}
 
+	/*! \brief It start the synchronization of the ghost parts
+	 *
+	 * The internal ghost are packed and sent, the receives are posted and the local ghost are
+	 * synchronized. The ghost coming from other processors are written only by ghost_wait, so
+	 * between Ighost_get and ghost_wait the points that does not need the ghost (the interior)
+	 * can be updated while the halo is in flight. The domain must not be modified after Ighost_get
+	 * if the modification must be visible in the ghost of the other processors
+	 *
+	 * \warning every Ighost_get must be completed by ghost_wait with the same properties
+	 *
+	 * \note the internal ghost are always packed, also when ghost_get would send them directly from
+	 *       the local grids with MPI datatypes, so the domain can be modified before ghost_wait
+	 *
+	 * \tparam prp... Properties to synchronize
+	 *
+	 * \param opt options (same as ghost_get)
+	 *
+	 */
+	template<int... prp> void Ighost_get(size_t opt = 0)
+	{
+#ifdef SE_CLASS2
+		check_valid(this,8);
+#endif
+
+		// Convert the ghost  internal boxes into grid unit boxes
+		create_ig_box();
+
+		// Convert the ghost external boxes into grid unit boxes
+		create_eg_box();
+
+		// Convert the local ghost internal boxes into grid unit boxes
+		create_local_ig_box();
+
+		// Convert the local external ghost boxes into grid unit boxes
+		create_local_eg_box();
+
+		grid_dist_id_comm<dim,St,T,Decomposition,Memory,device_grid>::template Ighost_get_<prp...>(ig_box,
+																								   eg_box,
+																								   loc_ig_box,
+																								   loc_eg_box,
+																								   gdb_ext,
+																								   eb_gid_list,
+																								   use_bx_def,
+																								   loc_grid,
+																								   ginfo_v,
+																								   g_id_to_external_ghost_box,
+																								   opt);
+	}
+
+	/*! \brief It complete the synchronization of the ghost parts started with Ighost_get
+	 *
+	 * It wait the ghost coming from the other processors and write them in the external ghost
+	 *
+	 * \tparam prp... Properties to synchronize (the same of Ighost_get)
+	 *
+	 */
+	template<int... prp> void ghost_wait()
+	{
+#ifdef SE_CLASS2
+		check_valid(this,8);
+#endif
+
+		grid_dist_id_comm<dim,St,T,Decomposition,Memory,device_grid>::template ghost_wait_<prp...>(eg_box,
+																								   loc_grid,
+																								   g_id_to_external_ghost_box,
+																								   eb_gid_list);
+	}
+
 	/*! \brief It synchronize the ghost parts
 	 *
 	 * \tparam prp... Properties to synchronize
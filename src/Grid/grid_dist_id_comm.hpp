@@ -11,8 +11,10 @@
 #include "Vector/vector_dist_ofb.hpp"
 #include "Grid/copy_grid_fast.hpp"
 #include "grid_dist_util.hpp"
+#include "grid_dist_ghost_dtype.hpp"
 #include "util/common_pdata.hpp"
 #include "lib/pdata.hpp"
+#include <map>
 
 
 /*! \brief Unpack selector
@@ -201,6 +203,24 @@ class grid_dist_id_comm
 	//! Receiving option
 	size_t opt;
 
+	//! receiving buffer of the ghost_get in flight (Ighost_get_)
+	ExtPreAlloc<Memory> * prRecv_prp_async = NULL;
+
+	//! size of the messages to receive of the ghost_get in flight
+	std::vector<size_t> prp_recv_async;
+
+	//! options of the ghost_get in flight
+	size_t opt_async = 0;
+
+	//! datatypes of the ghost_get without packing for each set of properties
+	std::map<std::vector<int>,ghost_dtype_cache> g_dtype;
+
+	//! plan of the packed ghost_get for each set of properties
+	std::map<std::vector<int>,ghost_plan<dim>> g_plan;
+
+	//! copies of the local ghost
+	openfpm::vector<ghost_copy_task<dim>> copy_tasks;
+
 	/*! \brief Sync the local ghost part
 	 *
 	 * \tparam prp... properties to sync
@@ -234,6 +254,12 @@ class grid_dist_id_comm
 		grid_key_dx<dim> cnt[1];
 		cnt[0].zero();
 
+		// On dense grids on CPU the copies are independent, they are collected, split in slabs and
+		// distributed across threads
+		bool par_copy = device_grid::isCompressed() == false && T::noPointers() == true && !(opt & RUN_ON_DEVICE);
+		size_t tot_copy = 0;
+		copy_tasks.clear();
+
 		//! For all the sub-domains
 		for (size_t i = 0 ; i < loc_ig_box.size() ; i++)
 		{
@@ -280,11 +306,17 @@ class grid_dist_id_comm
 					auto & gd = loc_grid.get(sub_id_dst_gdb_ext);
 
 					gd.remove(bx_dst);
-					gd.copy_to(loc_grid.get(sub_id_src_gdb_ext),bx_src,bx_dst);
+
+					if (par_copy == true)
+					{tot_copy += ghost_copy_add(copy_tasks,sub_id_src_gdb_ext,bx_src,sub_id_dst_gdb_ext,bx_dst);}
+					else
+					{gd.copy_to(loc_grid.get(sub_id_src_gdb_ext),bx_src,bx_dst);}
 				}
 			}
 		}
 
+		ghost_copy_run(copy_tasks,loc_grid,tot_copy >= ghost_copy_omp_min);
+
 		for (size_t i = 0 ; i < loc_grid.size() ; i++)
 		{
 			loc_grid.get(i).template removeCopyToFinalize<prp ...>(v_cl.getmgpuContext(), rem_copy_opt::PHASE1 | opt_);
@@ -412,7 +444,8 @@ class grid_dist_id_comm
 	template <typename prp_object>
 	void queue_recv_data_get(const openfpm::vector<ep_box_grid<dim>> & eg_box,
 			    		 std::vector<size_t> & prp_recv,
-						 ExtPreAlloc<Memory> & prRecv_prp)
+						 ExtPreAlloc<Memory> & prRecv_prp,
+						 ghost_plan<dim> & plan)
 	{
 #ifdef __NVCC__
 		cudaDeviceSynchronize();
@@ -420,12 +453,21 @@ class grid_dist_id_comm
 
 		if (device_grid::isCompressed() == false)
 		{
-			//! Receive the information from each processors
-			for ( size_t i = 0 ; i < eg_box.size() ; i++ )
+			//! Receive the information from each processors (calculated once for each plan)
+			if (plan.valid_recv == false)
 			{
-				prp_recv.push_back(eg_box.get(i).recv_pnt * sizeof(prp_object) + sizeof(size_t)*eg_box.get(i).n_r_box);
+				plan.prp_recv.clear();
+
+				for ( size_t i = 0 ; i < eg_box.size() ; i++ )
+				{
+					plan.prp_recv.push_back(eg_box.get(i).recv_pnt * sizeof(prp_object) + sizeof(size_t)*eg_box.get(i).n_r_box);
+				}
+
+				plan.valid_recv = true;
 			}
 
+			prp_recv = plan.prp_recv;
+
 			size_t tot_recv = ExtPreAlloc<Memory>::calculateMem(prp_recv);
 
 			//! Resize the receiving buffer
@@ -1175,7 +1217,87 @@ public:
 		grids_reconstruct(m_oGrid_recv,loc_grid,gdb_ext,cd_sm);
 	}
 
-	/*! \brief It fill the ghost part of the grids
+	/*! \brief Create (if needed) the plan of the packed ghost_get
+	 *
+	 * It calculate the boxes to pack in local grid coordinates and the size of the send buffer.
+	 * For dense grids with properties without pointers the plan is reused by the following ghost_get
+	 * with the same properties until reset_ghost_plan, one plan is kept for each set of properties
+	 *
+	 * \tparam prp properties to synchronize
+	 *
+	 * \param ig_box internal ghost box
+	 * \param gdb_ext local grids information
+	 * \param loc_grid set of local grid
+	 *
+	 * \return the plan for the properties prp
+	 *
+	 */
+	template<int... prp> ghost_plan<dim> & ghost_plan_create(const openfpm::vector<ip_box_grid<dim>> & ig_box,
+															  const openfpm::vector<GBoxes<device_grid::dims>> & gdb_ext,
+															  openfpm::vector<device_grid> & loc_grid)
+	{
+		ghost_plan<dim> & plan = this->g_plan[std::vector<int>({prp...})];
+
+		// compressed grids calculate in packRequest what they pack, and properties with pointers
+		// have a size that depend on the content, so they cannot reuse the plan
+		if (plan.valid == true && device_grid::isCompressed() == false && T::noPointers() == true)
+		{return plan;}
+
+		plan.clear();
+
+		size_t req = 0;
+
+		// Calculating the size to pack all the data to send
+		for ( size_t i = 0 ; i < ig_box.size() ; i++ )
+		{
+			plan.box_start.add(plan.box.size());
+
+			// for each ghost box
+			for (size_t j = 0 ; j < ig_box.get(i).bid.size() ; j++)
+			{
+				// And linked sub-domain
+				size_t sub_id = ig_box.get(i).bid.get(j).sub;
+				// Internal ghost box
+				Box<dim,long int> g_ig_box = ig_box.get(i).bid.get(j).box;
+
+				if (g_ig_box.isValid() == false)
+				{continue;}
+
+				g_ig_box -= gdb_ext.get(sub_id).origin.template convertPoint<size_t>();
+
+				// Pack a size_t for the internal ghost id
+				Packer<size_t,Memory>::packRequest(req);
+				// Create a sub grid iterator spanning the internal ghost layer
+				auto sub_it = loc_grid.get(sub_id).getIterator(g_ig_box.getKP1(),g_ig_box.getKP2(),false);
+
+				// get the size to pack
+				Packer<device_grid,Memory>::template packRequest<decltype(sub_it),prp...>(loc_grid.get(sub_id),sub_it,req);
+
+				plan.box.add();
+				plan.box.last().box = g_ig_box;
+				plan.box.last().sub = sub_id;
+				plan.box.last().g_id = ig_box.get(i).bid.get(j).g_id;
+			}
+		}
+
+		plan.box_start.add(plan.box.size());
+
+		plan.req = req;
+		plan.prp = {prp...};
+		plan.valid = true;
+
+		return plan;
+	}
+
+	/*! \brief Start the synchronization of the ghost part (see ghost_get_)
+	 *
+	 * It pack and send the internal ghost, post the receives and synchronize the local ghost. The ghost coming from
+	 * other processors are written only by ghost_wait_, so in the meanwhile the domain can be updated.
+	 * Every Ighost_get_ must be followed by a ghost_wait_ before the next one
+	 *
+	 * \note Ighost_get_ always pack, also when ghost_get_ would use the MPI datatypes (ghost_get_dtype_). The
+	 *       datatypes send directly from the domain, so the domain could not be modified until ghost_wait_
+	 *       without changing the ghost that the other processors receive
 	 *
 	 * \param ig_box internal ghost box
 	 * \param eg_box external ghost box
@@ -1186,7 +1308,7 @@ public:
 	 * \param g_id_to_external_ghost_box index to external ghost box
 	 *
 	 */
-	template<int... prp> void ghost_get_(const openfpm::vector<ip_box_grid<dim>> & ig_box,
+	template<int... prp> void Ighost_get_(const openfpm::vector<ip_box_grid<dim>> & ig_box,
 									     const openfpm::vector<ep_box_grid<dim>> & eg_box,
 										 const openfpm::vector<i_lbox_grid<dim>> & loc_ig_box,
 										 const openfpm::vector<e_lbox_grid<dim>> & loc_eg_box,
@@ -1234,31 +1356,10 @@ public:
 			for (size_t i = 0 ; i < loc_grid.size() ; i++)
 			{loc_grid.get(i).packReset();}
 
-			// Calculating the size to pack all the data to send
-			for ( size_t i = 0 ; i < ig_box.size() ; i++ )
-			{
-				// for each ghost box
-				for (size_t j = 0 ; j < ig_box.get(i).bid.size() ; j++)
-				{
-					// And linked sub-domain
-					size_t sub_id = ig_box.get(i).bid.get(j).sub;
-					// Internal ghost box
-					Box<dim,long int> g_ig_box = ig_box.get(i).bid.get(j).box;
-
-					if (g_ig_box.isValid() == false)
-					{continue;}
-
-					g_ig_box -= gdb_ext.get(sub_id).origin.template convertPoint<size_t>();
-
-					// Pack a size_t for the internal ghost id
-					Packer<size_t,Memory>::packRequest(req);
-					// Create a sub grid iterator spanning the internal ghost layer
-					auto sub_it = loc_grid.get(sub_id).getIterator(g_ig_box.getKP1(),g_ig_box.getKP2(),false);
-
-					// get the size to pack
-					Packer<device_grid,Memory>::template packRequest<decltype(sub_it),prp...>(loc_grid.get(sub_id),sub_it,req);
-				}
-			}
+			// the boxes to pack and the size of the send buffer are calculated only
+			// the first time for a set of properties
+			ghost_plan<dim> & plan = ghost_plan_create<prp...>(ig_box,gdb_ext,loc_grid);
+			req = plan.req;
 
 			// Finalize calculation
 			for (size_t i = 0 ; i < loc_grid.size() ; i++)
@@ -1291,19 +1392,14 @@ public:
 				{pointer = prAlloc_prp.getPointerEnd();}
 
 				// for each ghost box
-				for (size_t j = 0 ; j < ig_box.get(i).bid.size() ; j++)
+				for (size_t j = plan.box_start.get(i) ; j < plan.box_start.get(i+1) ; j++)
 				{
-					// we pack only if it is valid
-					if (ig_box.get(i).bid.get(j).box.isValid() == false)
-						continue;
-
 					// And linked sub-domain
-					size_t sub_id = ig_box.get(i).bid.get(j).sub;
+					size_t sub_id = plan.box.get(j).sub;
 					// Internal ghost box
-					Box<dim,size_t> g_ig_box = ig_box.get(i).bid.get(j).box;
-					g_ig_box -= gdb_ext.get(sub_id).origin.template convertPoint<size_t>();
+					const Box<dim,size_t> & g_ig_box = plan.box.get(j).box;
 					// Ghost box global id
-					size_t g_id = ig_box.get(i).bid.get(j).g_id;
+					size_t g_id = plan.box.get(j).g_id;
 
 					// Pack a size_t for the internal ghost id
 					Packer<size_t,Memory>::pack(prAlloc_prp,g_id,sts);
@@ -1342,6 +1438,10 @@ public:
 		{
 			req = g_send_prp_mem.size();
 
+			// the receive sizes are taken from the plan
+			if (device_grid::isCompressed() == false)
+			{ghost_plan_create<prp...>(ig_box,gdb_ext,loc_grid);}
+
 			// Create an object of preallocated memory for properties
 			ExtPreAlloc<Memory> & prAlloc_prp = *(new ExtPreAlloc<Memory>(req,g_send_prp_mem));
 			prAlloc_prp.incRef();
@@ -1382,7 +1482,7 @@ public:
 		// Before wait for the communication to complete we sync the local ghost
 		// in order to overlap with communication
 
-		queue_recv_data_get<prp_object>(eg_box,prp_recv,prRecv_prp);
+		queue_recv_data_get<prp_object>(eg_box,prp_recv,prRecv_prp,g_plan[std::vector<int>({prp...})]);
 
 		#ifdef ENABLE_GRID_DIST_ID_PERF_STATS
 		sendrecv_time.stop();
@@ -1396,6 +1496,38 @@ public:
 		#ifdef ENABLE_GRID_DIST_ID_PERF_STATS
 		merge_loc_time.stop();
 		tot_loc_merge += merge_loc_time.getwct();
+		#endif
+
+		// the remote ghost are merged by ghost_wait_
+		prRecv_prp_async = &prRecv_prp;
+		prp_recv_async.swap(prp_recv);
+		opt_async = opt;
+	}
+
+	/*! \brief Complete the synchronization of the ghost part started with Ighost_get_
+	 *
+	 * \tparam prp properties to synchronize (the same of Ighost_get_)
+	 *
+	 * \param eg_box external ghost box
+	 * \param loc_grid set of local grid
+	 * \param g_id_to_external_ghost_box index to external ghost box
+	 * \param eb_gid_list for each external ghost box the list of the boxes with the same id
+	 *
+	 */
+	template<int... prp> void ghost_wait_(const openfpm::vector<ep_box_grid<dim>> & eg_box,
+										  openfpm::vector<device_grid> & loc_grid,
+										  std::unordered_map<size_t,size_t> & g_id_to_external_ghost_box,
+										  const openfpm::vector<e_box_multi<dim>> & eb_gid_list)
+	{
+		// nothing in flight
+		if (prRecv_prp_async == NULL)
+		{return;}
+
+		ExtPreAlloc<Memory> & prRecv_prp = *prRecv_prp_async;
+		std::vector<size_t> & prp_recv = prp_recv_async;
+		size_t opt = opt_async;
+
+		#ifdef ENABLE_GRID_DIST_ID_PERF_STATS
 		timer merge_time;
 		merge_time.start();
 		#endif
@@ -1419,6 +1551,258 @@ public:
 
 		prRecv_prp.decRef();
 		delete &prRecv_prp;
+
+		prRecv_prp_async = NULL;
+	}
+
+	/*! \brief Indicate if the ghost_get can send and receive directly from the local grids without packing
+	 *
+	 * It is possible for dense grids on CPU when the properties does not contain pointers and they
+	 * are stored in memory with a constant stride
+	 *
+	 * \tparam prp properties to synchronize
+	 *
+	 * \param opt options
+	 *
+	 * \return true if the ghost_get can use MPI datatypes
+	 *
+	 */
+	template<int... prp> bool ghost_dtype_possible(size_t opt)
+	{
+		return device_grid::isCompressed() == false &&
+			   T::noPointers() == true &&
+			   sizeof...(prp) != 0 &&
+			   ghost_dtype_addressable<device_grid,dim,prp...>::value == true &&
+			   !(opt & RUN_ON_DEVICE);
+	}
+
+	/*! \brief Create (if needed) the datatypes of the ghost_get without packing
+	 *
+	 * The datatypes are reused until the local grids are reallocated or the ghost boxes change
+	 * (reset_ghost_plan), one set of datatypes is kept for each set of properties
+	 *
+	 * \tparam prp properties to synchronize
+	 *
+	 * \param ig_box internal ghost box
+	 * \param eg_box external ghost box
+	 * \param gdb_ext local grids information
+	 * \param eb_gid_list for each received box the linked external ghost boxes
+	 * \param loc_grid set of local grid
+	 *
+	 * \return the datatypes for the properties prp
+	 *
+	 */
+	template<int... prp> ghost_dtype_cache & ghost_dtype_create(const openfpm::vector<ip_box_grid<dim>> & ig_box,
+												 const openfpm::vector<ep_box_grid<dim>> & eg_box,
+												 const openfpm::vector<GBoxes<device_grid::dims>> & gdb_ext,
+												 const openfpm::vector<e_box_multi<dim>> & eb_gid_list,
+												 openfpm::vector<device_grid> & loc_grid)
+	{
+		typedef ghost_dtype_impl<ghost_dtype_addressable<device_grid,dim,prp...>::value> impl;
+
+		std::vector<void *> bs;
+		impl::template base<prp...>(loc_grid,bs);
+
+		std::vector<int> prp_l({prp...});
+
+		ghost_dtype_cache & dt = this->g_dtype[prp_l];
+
+		if (dt.valid == true && dt.base == bs)
+		{return dt;}
+
+		dt.clear();
+
+		openfpm::vector<int> bl;
+		openfpm::vector<MPI_Aint> disp;
+		openfpm::vector<MPI_Datatype> tp;
+
+		// The boxes are selected in the same order used by the packing, the sender in the order
+		// of ig_box, the receiver in the order of eb_gid_list that follow the received boxes
+		for (size_t i = 0 ; i < ig_box.size() ; i++)
+		{
+			for (size_t j = 0 ; j < ig_box.get(i).bid.size() ; j++)
+			{
+				size_t sub_id = ig_box.get(i).bid.get(j).sub;
+				Box<dim,long int> g_ig_box = ig_box.get(i).bid.get(j).box;
+
+				if (g_ig_box.isValid() == false)
+				{continue;}
+
+				g_ig_box -= gdb_ext.get(sub_id).origin;
+
+				impl::template add_box<prp...>(loc_grid.get(sub_id),g_ig_box,bl,disp,tp);
+			}
+
+			dt.send.add(ghost_dtype_merge(bl,disp,tp));
+		}
+
+		openfpm::vector<openfpm::vector<size_t>> recv_box(eg_box.size());
+
+		for (size_t l_id = 0 ; l_id < eb_gid_list.size() ; l_id++)
+		{recv_box.get(eb_gid_list.get(l_id).e_id).add(l_id);}
+
+		for (size_t i = 0 ; i < eg_box.size() ; i++)
+		{
+			for (size_t j = 0 ; j < recv_box.get(i).size() ; j++)
+			{
+				size_t l_id = recv_box.get(i).get(j);
+				size_t le_id = eb_gid_list.get(l_id).full_match;
+
+				Box<dim,long int> box = eg_box.get(i).bid.get(le_id).l_e_box;
+				size_t sub_id = eg_box.get(i).bid.get(le_id).sub;
+
+				impl::template add_box<prp...>(loc_grid.get(sub_id),box,bl,disp,tp);
+			}
+
+			dt.recv.add(ghost_dtype_merge(bl,disp,tp));
+		}
+
+		dt.base.swap(bs);
+		dt.prp.swap(prp_l);
+		dt.valid = true;
+
+		return dt;
+	}
+
+	/*! \brief It fill the ghost part of the grids without packing
+	 *
+	 * The internal ghost are sent directly from the local grids and the external ghost are received
+	 * directly into the local grids using MPI datatypes (see ghost_dtype_create), this avoid two
+	 * copies of the ghost for each exchange. The local ghost are synchronized while the messages are in flight
+	 *
+	 * \param ig_box internal ghost box
+	 * \param eg_box external ghost box
+	 * \param loc_ig_box local internal ghost box
+	 * \param loc_eg_box local external ghost box
+	 * \param gdb_ext local grids information
+	 * \param eb_gid_list for each received box the linked external ghost boxes
+	 * \param use_bx_def indicate if the grid is defined only on a set of boxes
+	 * \param loc_grid set of local grid
+	 * \param ginfo grid information
+	 * \param g_id_to_external_ghost_box index to external ghost box
+	 * \param opt options
+	 *
+	 */
+	template<int... prp> void ghost_get_dtype_(const openfpm::vector<ip_box_grid<dim>> & ig_box,
+											   const openfpm::vector<ep_box_grid<dim>> & eg_box,
+											   const openfpm::vector<i_lbox_grid<dim>> & loc_ig_box,
+											   const openfpm::vector<e_lbox_grid<dim>> & loc_eg_box,
+											   const openfpm::vector<GBoxes<device_grid::dims>> & gdb_ext,
+											   const openfpm::vector<e_box_multi<dim>> & eb_gid_list,
+											   bool use_bx_def,
+											   openfpm::vector<device_grid> & loc_grid,
+											   const grid_sm<dim,void> & ginfo,
+											   std::unordered_map<size_t,size_t> & g_id_to_external_ghost_box,
+											   size_t opt)
+	{
+#ifdef PROFILE_SCOREP
+		SCOREP_USER_REGION("ghost_get",SCOREP_USER_REGION_TYPE_FUNCTION)
+#endif
+
+		ghost_dtype_cache & dt = ghost_dtype_create<prp...>(ig_box,eg_box,gdb_ext,eb_gid_list,loc_grid);
+
+		dt.req.clear();
+
+		// Every near processor send and receive a message (eventually empty) like the packed ghost_get
+		for (size_t i = 0 ; i < eg_box.size() ; i++)
+		{
+			dt.req.add();
+
+			if (dt.recv.get(i) == MPI_DATATYPE_NULL)
+			{MPI_Irecv(NULL,0,MPI_BYTE,eg_box.get(i).prc,0,v_cl.getMPIComm(),&dt.req.last());}
+			else
+			{MPI_Irecv(MPI_BOTTOM,1,dt.recv.get(i),eg_box.get(i).prc,0,v_cl.getMPIComm(),&dt.req.last());}
+		}
+
+		for (size_t i = 0 ; i < ig_box.size() ; i++)
+		{
+			dt.req.add();
+
+			if (dt.send.get(i) == MPI_DATATYPE_NULL)
+			{MPI_Isend(NULL,0,MPI_BYTE,ig_box.get(i).prc,0,v_cl.getMPIComm(),&dt.req.last());}
+			else
+			{MPI_Isend(MPI_BOTTOM,1,dt.send.get(i),ig_box.get(i).prc,0,v_cl.getMPIComm(),&dt.req.last());}
+		}
+
+		ghost_get_local<prp...>(loc_ig_box,loc_eg_box,gdb_ext,loc_grid,g_id_to_external_ghost_box,ginfo,use_bx_def,opt);
+
+		if (dt.req.size() != 0)
+		{MPI_Waitall(dt.req.size(),&dt.req.get(0),MPI_STATUSES_IGNORE);}
+
+		// Copy the received boxes on the other linked external ghost boxes
+		size_t tot_copy = 0;
+		copy_tasks.clear();
+
+		for (size_t l_id = 0 ; l_id < eb_gid_list.size() ; l_id++)
+		{
+			size_t le_id = eb_gid_list.get(l_id).full_match;
+			size_t ei =	eb_gid_list.get(l_id).e_id;
+			size_t sub_id = eg_box.get(ei).bid.get(le_id).sub;
+
+			for (size_t j = 0 ; j < eb_gid_list.get(l_id).eb_list.size() ; j++)
+			{
+				size_t nle_id = eb_gid_list.get(l_id).eb_list.get(j);
+				if (nle_id != le_id)
+				{
+					size_t n_sub_id = eg_box.get(ei).bid.get(nle_id).sub;
+
+					Box<dim,long int> box = eg_box.get(ei).bid.get(nle_id).l_e_box;
+					Box<dim,long int> rbox = eg_box.get(ei).bid.get(nle_id).lr_e_box;
+
+					tot_copy += ghost_copy_add(copy_tasks,sub_id,rbox,n_sub_id,box);
+				}
+			}
+		}
+
+		ghost_copy_run(copy_tasks,loc_grid,tot_copy >= ghost_copy_omp_min);
+	}
+
+	/*! \brief Invalidate the plans of the ghost_get (packed and without packing) of all the sets of properties
+	 *
+	 * It must be called when the ghost boxes change
+	 *
+	 */
+	void reset_ghost_plan()
+	{
+		g_dtype.clear();
+		g_plan.clear();
+	}
+
+	/*! \brief It fill the ghost part of the grids
+	 *
+	 * For dense grids on CPU with properties without pointers the ghost are sent and received
+	 * directly from the local grids (see ghost_get_dtype_)
+	 *
+	 * \param ig_box internal ghost box
+	 * \param eg_box external ghost box
+	 * \param loc_ig_box local internal ghost box
+	 * \param loc_eg_box local external ghost box
+	 * \param gdb_ext local grids information
+	 * \param loc_grid set of local grid
+	 * \param g_id_to_external_ghost_box index to external ghost box
+	 *
+	 */
+	template<int... prp> void ghost_get_(const openfpm::vector<ip_box_grid<dim>> & ig_box,
+									     const openfpm::vector<ep_box_grid<dim>> & eg_box,
+										 const openfpm::vector<i_lbox_grid<dim>> & loc_ig_box,
+										 const openfpm::vector<e_lbox_grid<dim>> & loc_eg_box,
+			                             const openfpm::vector<GBoxes<device_grid::dims>> & gdb_ext,
+										 const openfpm::vector<e_box_multi<dim>> & eb_gid_list,
+										 bool use_bx_def,
+										 openfpm::vector<device_grid> & loc_grid,
+										 const grid_sm<dim,void> & ginfo,
+										 std::unordered_map<size_t,size_t> & g_id_to_external_ghost_box,
+										 size_t opt)
+	{
+		if (ghost_dtype_possible<prp...>(opt) == true)
+		{
+			ghost_get_dtype_<prp...>(ig_box,eg_box,loc_ig_box,loc_eg_box,gdb_ext,eb_gid_list,use_bx_def,loc_grid,ginfo,g_id_to_external_ghost_box,opt);
+			return;
+		}
+
+		Ighost_get_<prp...>(ig_box,eg_box,loc_ig_box,loc_eg_box,gdb_ext,eb_gid_list,use_bx_def,loc_grid,ginfo,g_id_to_external_ghost_box,opt);
+
+		ghost_wait_<prp...>(eg_box,loc_grid,g_id_to_external_ghost_box,eb_gid_list);
 	}
 
 	/*! \brief It merge the information in the ghost with the
@@ -598,4 +598,153 @@ template <unsigned int dim> struct e_lbox_grid
 };
 
 
+//! Number of points of the slabs in which the copies of the ghost are split
+constexpr size_t ghost_copy_slab = 32768;
+
+//! Minimum number of points of the copies of the ghost to use more threads
+constexpr size_t ghost_copy_omp_min = 65536;
+
+/*! \brief Copy of a box between two local grids
+ *
+ */
+template <unsigned int dim> struct ghost_copy_task
+{
+	//! source box in local grid coordinates
+	Box<dim,long int> bx_src;
+
+	//! destination box in local grid coordinates
+	Box<dim,long int> bx_dst;
+
+	//! source local grid
+	size_t sub_src;
+
+	//! destination local grid
+	size_t sub_dst;
+};
+
+/*! \brief Add the copy of bx_src into bx_dst to the list of copies
+ *
+ * Boxes bigger than ghost_copy_slab points are split in slabs along the last dimension, so that the copy of
+ * a big box can be distributed across threads
+ *
+ * \param tasks list of copies
+ * \param sub_src source local grid
+ * \param bx_src source box
+ * \param sub_dst destination local grid
+ * \param bx_dst destination box (same size of bx_src)
+ *
+ * \return the number of points to copy
+ *
+ */
+template<unsigned int dim>
+inline size_t ghost_copy_add(openfpm::vector<ghost_copy_task<dim>> & tasks,
+							 size_t sub_src, const Box<dim,long int> & bx_src,
+							 size_t sub_dst, const Box<dim,long int> & bx_dst)
+{
+	size_t vol = bx_dst.getVolumeKey();
+	long int n_l = bx_dst.getHigh(dim-1) - bx_dst.getLow(dim-1) + 1;
+
+	// number of layers of the last dimension in one slab
+	long int n_slab = ghost_copy_slab / (vol / n_l);
+	n_slab = (n_slab == 0)?1:n_slab;
+
+	for (long int l = 0 ; l < n_l ; l += n_slab)
+	{
+		long int h = (l + n_slab - 1 < n_l - 1)?l + n_slab - 1:n_l - 1;
+
+		tasks.add();
+		tasks.last().bx_src = bx_src;
+		tasks.last().bx_dst = bx_dst;
+		tasks.last().bx_src.setLow(dim-1,bx_src.getLow(dim-1) + l);
+		tasks.last().bx_src.setHigh(dim-1,bx_src.getLow(dim-1) + h);
+		tasks.last().bx_dst.setLow(dim-1,bx_dst.getLow(dim-1) + l);
+		tasks.last().bx_dst.setHigh(dim-1,bx_dst.getLow(dim-1) + h);
+		tasks.last().sub_src = sub_src;
+		tasks.last().sub_dst = sub_dst;
+	}
+
+	return vol;
+}
+
+/*! \brief Execute the list of copies
+ *
+ * The destination boxes must not overlap
+ *
+ * \param tasks list of copies
+ * \param loc_grid local grids
+ * \param par true to distribute the copies across threads
+ *
+ */
+template<unsigned int dim, typename device_grid>
+inline void ghost_copy_run(const openfpm::vector<ghost_copy_task<dim>> & tasks, openfpm::vector<device_grid> & loc_grid, bool par)
+{
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic) if (par)
+#endif
+	for (long int t = 0 ; t < (long int)tasks.size() ; t++)
+	{
+		const ghost_copy_task<dim> & tk = tasks.get(t);
+
+		loc_grid.get(tk.sub_dst).copy_to(loc_grid.get(tk.sub_src),tk.bx_src,tk.bx_dst);
+	}
+}
+
+/*! \brief Internal ghost box to pack, in local grid coordinates
+ *
+ */
+template <unsigned int dim> struct ghost_plan_box
+{
+	//! internal ghost box in local grid coordinates
+	Box<dim,size_t> box;
+
+	//! local grid
+	size_t sub;
+
+	//! ghost box global id
+	size_t g_id;
+};
+
+/*! \brief Plan of a ghost_get
+ *
+ * It store what the packed ghost_get compute from the ghost boxes (the boxes to pack in local grid coordinates,
+ * the size of the send buffer and the size of the messages to receive), so that the following ghost_get with
+ * the same properties only pack, communicate and unpack. It is invalidated when the ghost boxes change
+ *
+ */
+template <unsigned int dim> struct ghost_plan
+{
+	//! properties the plan has been created for
+	std::vector<int> prp;
+
+	//! boxes to pack, the boxes of the processor i are from box_start.get(i) to box_start.get(i+1)
+	openfpm::vector<ghost_plan_box<dim>> box;
+
+	//! start of the boxes of each processor in box (one more element than the processors)
+	openfpm::vector<size_t> box_start;
+
+	//! size of the send buffer
+	size_t req = 0;
+
+	//! size of the message to receive from each processor
+	std::vector<size_t> prp_recv;
+
+	//! true if the boxes and the send size are valid
+	bool valid = false;
+
+	//! true if the receive sizes are valid
+	bool valid_recv = false;
+
+	//! Invalidate the plan
+	void clear()
+	{
+		prp.clear();
+		box.clear();
+		box_start.clear();
+		prp_recv.clear();
+		req = 0;
+		valid = false;
+		valid_recv = false;
+	}
+};
+
 #endif /* SRC_GRID_GRID_DIST_UTIL_HPP_ */
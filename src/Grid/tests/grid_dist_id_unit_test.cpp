@@ -2456,6 +2456,445 @@ BOOST_AUTO_TEST_CASE( grid_dist_ghost_zero_size )
 	BOOST_REQUIRE_EQUAL(count,32*32*32);
 }
 
+BOOST_AUTO_TEST_CASE( grid_dist_id_Ighost_get_ghost_wait )
+{
+	Box<3,float> domain({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	Vcluster<> & v_cl = create_vcluster();
+
+	if ( v_cl.getProcessingUnits() > 32 )
+	{return;}
+
+	BOOST_TEST_CHECKPOINT( "Testing grid asynchronous ghost_get");
+
+	// grid size
+	size_t sz[3] = {64,64,64};
+
+	// Ghost
+	Ghost<3,long int> g(2);
+
+	// Distributed grid with id decomposition
+	grid_dist_id<3, float, aggregate<long int, long int>> g_dist(sz,domain,g);
+
+	grid_sm<3,void> info(sz);
+
+	auto dom = g_dist.getDomainIterator();
+
+	while (dom.isNext())
+	{
+		auto key = dom.get();
+		auto key_g = g_dist.getGKey(key);
+
+		g_dist.template get<0>(key) = info.LinId(key_g);
+		g_dist.template get<1>(key) = 0;
+
+		++dom;
+	}
+
+	g_dist.template Ighost_get<0>();
+
+	// update the domain while the ghost is in flight
+	auto dom2 = g_dist.getDomainIterator();
+
+	while (dom2.isNext())
+	{
+		auto key = dom2.get();
+
+		g_dist.template get<1>(key) = 2*g_dist.template get<0>(key);
+
+		++dom2;
+	}
+
+	g_dist.template ghost_wait<0>();
+
+	bool match = true;
+
+	auto domg = g_dist.getDomainGhostIterator();
+
+	while (domg.isNext())
+	{
+		auto key = domg.get();
+		auto key_g = g_dist.getGKey(key);
+
+		// In this case the boundary condition are non periodic
+		if (g_dist.isInside(key_g))
+		{match &= (g_dist.template get<0>(key) == (long int)info.LinId(key_g));}
+
+		++domg;
+	}
+
+	auto dom3 = g_dist.getDomainIterator();
+
+	while (dom3.isNext())
+	{
+		auto key = dom3.get();
+
+		match &= (g_dist.template get<1>(key) == 2*g_dist.template get<0>(key));
+
+		++dom3;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// a ghost_wait without an Ighost_get does nothing
+	g_dist.template ghost_wait<0>();
+}
+
+BOOST_AUTO_TEST_CASE( grid_dist_id_ghost_get_wide_periodic )
+{
+	Box<3,float> domain({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	Vcluster<> & v_cl = create_vcluster();
+
+	if ( v_cl.getProcessingUnits() > 32 )
+	{return;}
+
+	BOOST_TEST_CHECKPOINT( "Testing grid ghost_get with big local ghost copies");
+
+	// grid size
+	size_t sz[3] = {96,96,96};
+
+	// Ghost (the local copies are split in slabs and distributed across threads)
+	Ghost<3,long int> g(4);
+
+	// periodicity
+	periodicity<3> pr = {{PERIODIC,PERIODIC,PERIODIC}};
+
+	// Distributed grid with id decomposition
+	grid_dist_id<3, float, aggregate<long int>> g_dist(sz,domain,g,pr);
+
+	grid_sm<3,void> info(sz);
+
+	auto dom = g_dist.getDomainIterator();
+
+	while (dom.isNext())
+	{
+		auto key = dom.get();
+		auto key_g = g_dist.getGKey(key);
+
+		g_dist.template get<0>(key) = info.LinId(key_g);
+
+		++dom;
+	}
+
+	g_dist.template ghost_get<0>();
+
+	bool match = true;
+
+	auto domg = g_dist.getDomainGhostIterator();
+
+	while (domg.isNext())
+	{
+		auto key = domg.get();
+		auto key_g = g_dist.getGKey(key);
+
+		for (size_t i = 0 ; i < 3 ; i++)
+		{key_g.set_d(i,(key_g.get(i) + sz[i]) % sz[i]);}
+
+		match &= (g_dist.template get<0>(key) == (long int)info.LinId(key_g));
+
+		++domg;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE( grid_dist_id_comm_avoid_iterator )
+{
+	Box<3,float> domain({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	Vcluster<> & v_cl = create_vcluster();
+
+	if ( v_cl.getProcessingUnits() > 32 )
+	{return;}
+
+	BOOST_TEST_CHECKPOINT( "Testing grid communication avoiding iterator");
+
+	// grid size
+	size_t sz[3] = {32,32,32};
+
+	// radius of the stencil and steps for each ghost_get
+	size_t s = 1;
+	size_t k = 3;
+
+	// periodicity
+	periodicity<3> pr = {{PERIODIC,PERIODIC,PERIODIC}};
+
+	// Ghost
+	Ghost<3,long int> g(k*s);
+
+	// one grid synchronized every step, one every k steps
+	grid_dist_id<3, float, aggregate<double,double>> g_ref(sz,domain,g,pr);
+	grid_dist_id<3, float, aggregate<double,double>> g_ca(g_ref.getDecomposition(),sz,g);
+
+	auto dom = g_ref.getDomainIterator();
+
+	while (dom.isNext())
+	{
+		auto key = dom.get();
+		auto key_g = g_ref.getGKey(key);
+
+		g_ref.template get<0>(key) = (key_g.get(0) == 16 && key_g.get(1) == 16 && key_g.get(2) == 16)?1.0:0.0;
+		g_ca.template get<0>(key) = g_ref.template get<0>(key);
+
+		++dom;
+	}
+
+	auto stencil = [](grid_dist_id<3, float, aggregate<double,double>> & gr, grid_dist_key_dx<3> key)
+	{
+		double lap = - 6.0*gr.template get<0>(key);
+
+		for (size_t i = 0 ; i < 3 ; i++)
+		{lap += gr.template get<0>(key.move(i,1)) + gr.template get<0>(key.move(i,-1));}
+
+		gr.template get<1>(key) = gr.template get<0>(key) + 0.1*lap;
+	};
+
+	for (size_t t = 0 ; t < 2*k ; t++)
+	{
+		// reference
+		g_ref.template ghost_get<0>();
+
+		auto it = g_ref.getDomainIterator();
+
+		while (it.isNext())
+		{
+			stencil(g_ref,it.get());
+			++it;
+		}
+
+		auto it2 = g_ref.getDomainIterator();
+
+		while (it2.isNext())
+		{
+			auto key = it2.get();
+			g_ref.template get<0>(key) = g_ref.template get<1>(key);
+			++it2;
+		}
+
+		//! [communication avoiding stencil]
+
+		size_t m = t % k;
+
+		if (m == 0)
+		{g_ca.template ghost_get<0>();}
+
+		auto it_ca = g_ca.getCommAvoidIterator(s,k,m);
+
+		while (it_ca.isNext())
+		{
+			stencil(g_ca,it_ca.get());
+			++it_ca;
+		}
+
+		auto it_ca2 = g_ca.getCommAvoidIterator(s,k,m);
+
+		while (it_ca2.isNext())
+		{
+			auto key = it_ca2.get();
+			g_ca.template get<0>(key) = g_ca.template get<1>(key);
+			++it_ca2;
+		}
+
+		//! [communication avoiding stencil]
+	}
+
+	bool match = true;
+
+	auto it = g_ref.getDomainIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		match &= fabs(g_ref.template get<0>(key) - g_ca.template get<0>(key)) < 1e-14;
+
+		++it;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// the halo iterator with zero layers span the domain
+	size_t cnt = 0;
+	auto it_h = g_ca.getDomainHaloIterator(0);
+
+	while (it_h.isNext())
+	{
+		cnt++;
+		++it_h;
+	}
+
+	v_cl.sum(cnt);
+	v_cl.execute();
+
+	BOOST_REQUIRE_EQUAL(cnt,32*32*32);
+}
+
+BOOST_AUTO_TEST_CASE( grid_dist_id_ghost_plan_reuse )
+{
+	Box<3,float> domain({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	Vcluster<> & v_cl = create_vcluster();
+
+	if ( v_cl.getProcessingUnits() > 32 )
+	{return;}
+
+	BOOST_TEST_CHECKPOINT( "Testing grid ghost_get plan reuse");
+
+	// grid size
+	size_t sz[3] = {32,32,32};
+
+	// Ghost
+	Ghost<3,long int> g(1);
+
+	// Distributed grid with id decomposition
+	grid_dist_id<3, float, aggregate<long int, long int>> g_dist(sz,domain,g);
+
+	grid_sm<3,void> info(sz);
+
+	// the plan is created by the first exchange and reused by the following, changing
+	// the properties and after map
+	for (size_t k = 0 ; k < 4 ; k++)
+	{
+		auto dom = g_dist.getDomainIterator();
+
+		while (dom.isNext())
+		{
+			auto key = dom.get();
+			auto key_g = g_dist.getGKey(key);
+
+			g_dist.template get<0>(key) = info.LinId(key_g) + k;
+			g_dist.template get<1>(key) = 2*info.LinId(key_g) + k;
+
+			++dom;
+		}
+
+		if (k % 2 == 0)
+		{
+			g_dist.template Ighost_get<0>();
+			g_dist.template ghost_wait<0>();
+			g_dist.template Ighost_get<0,1>();
+			g_dist.template ghost_wait<0,1>();
+		}
+		else
+		{
+			g_dist.template Ighost_get<0,1>();
+			g_dist.template ghost_wait<0,1>();
+		}
+
+		bool match = true;
+
+		auto domg = g_dist.getDomainGhostIterator();
+
+		while (domg.isNext())
+		{
+			auto key = domg.get();
+			auto key_g = g_dist.getGKey(key);
+
+			if (g_dist.isInside(key_g))
+			{
+				match &= (g_dist.template get<0>(key) == (long int)(info.LinId(key_g) + k));
+				match &= (g_dist.template get<1>(key) == (long int)(2*info.LinId(key_g) + k));
+			}
+
+			++domg;
+		}
+
+		BOOST_REQUIRE_EQUAL(match,true);
+
+		if (k == 1)
+		{g_dist.map();}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( grid_dist_id_ghost_get_subset_properties )
+{
+	Box<3,float> domain({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	Vcluster<> & v_cl = create_vcluster();
+
+	if ( v_cl.getProcessingUnits() > 32 )
+	{return;}
+
+	BOOST_TEST_CHECKPOINT( "Testing grid ghost_get on a subset of properties");
+
+	// grid size
+	size_t sz[3] = {48,48,48};
+
+	// Ghost
+	Ghost<3,long int> g(1);
+
+	// periodicity
+	periodicity<3> pr = {{PERIODIC,PERIODIC,PERIODIC}};
+
+	// Distributed grid with id decomposition
+	grid_dist_id<3, float, aggregate<float,long int,double[3]>> g_dist(sz,domain,g,pr);
+
+	grid_sm<3,void> info(sz);
+
+	auto dom = g_dist.getDomainGhostIterator();
+
+	while (dom.isNext())
+	{
+		auto key = dom.get();
+
+		g_dist.template get<1>(key) = -1;
+
+		++dom;
+	}
+
+	auto dom2 = g_dist.getDomainIterator();
+
+	while (dom2.isNext())
+	{
+		auto key = dom2.get();
+		auto key_g = g_dist.getGKey(key);
+
+		g_dist.template get<0>(key) = info.LinId(key_g);
+		g_dist.template get<1>(key) = info.LinId(key_g);
+		g_dist.template get<2>(key)[0] = info.LinId(key_g);
+		g_dist.template get<2>(key)[1] = 2*info.LinId(key_g);
+		g_dist.template get<2>(key)[2] = 3*info.LinId(key_g);
+
+		++dom2;
+	}
+
+	// two times, the second reuse the communication structures
+	for (size_t k = 0 ; k < 2 ; k++)
+	{
+		g_dist.template ghost_get<0,2>();
+
+		bool match = true;
+
+		auto domg = g_dist.getDomainGhostIterator();
+
+		while (domg.isNext())
+		{
+			auto key = domg.get();
+			auto key_g = g_dist.getGKey(key);
+
+			// periodic
+			for (size_t i = 0 ; i < 3 ; i++)
+			{key_g.set_d(i,(key_g.get(i) + sz[i]) % sz[i]);}
+
+			long int id = info.LinId(key_g);
+
+			match &= (g_dist.template get<0>(key) == id);
+			match &= (g_dist.template get<2>(key)[0] == id);
+			match &= (g_dist.template get<2>(key)[1] == 2*id);
+			match &= (g_dist.template get<2>(key)[2] == 3*id);
+
+			// property 1 is not synchronized
+			if (g_dist.isInside(g_dist.getGKey(key)) == false)
+			{match &= (g_dist.template get<1>(key) == -1);}
+
+			++domg;
+		}
+
+		BOOST_REQUIRE_EQUAL(match,true);
+	}
+}
+
 
 BOOST_AUTO_TEST_CASE(grid_dist_id_smb_write_out_1_proc)
 {
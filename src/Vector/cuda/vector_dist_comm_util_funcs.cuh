@@ -17,10 +17,18 @@ constexpr int NO_CHANGE_ELEMENTS = 4;
 constexpr int BIND_DEC_TO_GHOST = 1;
 
 constexpr int MAP_LOCAL = 2;
+constexpr int MAP_SEND_ARENA = 4096;
+constexpr int MAP_LAZY = 8192;
+constexpr int GHOST_REDUCED_PRECISION = 16384;
+constexpr int GHOST_AUTO_REUSE = 32768;
 
 constexpr int GHOST_SYNC = 0;
 constexpr int GHOST_ASYNC = 1;
 
+constexpr int GHOST_REUSE_NONE = 0;
+constexpr int GHOST_REUSE_LABELLING = 1;
+constexpr int GHOST_REUSE_ALL = 2;
+
 template<unsigned int dim, typename St, typename prop, typename Memory, template<typename> class layout_base, typename Decomposition, bool is_ok_cuda>
 struct labelParticlesGhost_impl
 {
@@ -319,6 +319,97 @@ BOOST_AUTO_TEST_CASE( vector_dist_particle_iteration )
 	BOOST_REQUIRE_EQUAL((long int)count,k);
 }
 
+
+BOOST_AUTO_TEST_CASE( vector_dist_parallel_for_domain )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	if (v_cl.getProcessingUnits() > 12)
+		return;
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+
+	long int k = 5000 * v_cl.getProcessingUnits();
+
+	print_test_v("Testing 3D parallel domain iteration k=",k);
+	BOOST_TEST_CHECKPOINT( "Testing 3D parallel domain iteration k=" << k );
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	float r_cut = 0.1;
+
+	// ghost
+	Ghost<3,float> ghost(r_cut);
+
+	vector_dist<3,float, aggregate<float,int> > vd(k,box,bc,ghost,BIND_DEC_TO_GHOST);
+
+	auto it = vd.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		vd.getPos(key)[0] = ud(eg);
+		vd.getPos(key)[1] = ud(eg);
+		vd.getPos(key)[2] = ud(eg);
+
+		++it;
+	}
+
+	vd.map();
+	vd.ghost_get<>();
+
+	// inside the threaded loops only the NC accessors are used
+	vd.parallel_for_domain([&](vect_dist_key_dx p)
+	{
+		vd.getPropNC<0>(p) = vd.getPosNC(p)[0] + vd.getPosNC(p)[1];
+		vd.getPropNC<1>(p) = 0;
+	},64);
+
+	// every particle visited once with the thread blocks
+#ifdef _OPENMP
+	#pragma omp parallel
+#endif
+	{
+		auto it2 = vd.getDomainIteratorParallel();
+
+		while (it2.isNext())
+		{
+			auto p = it2.get();
+
+			vd.getPropNC<1>(p) += 1;
+
+			++it2;
+		}
+	}
+
+	// and once with the cells
+	auto NN = vd.getCellListSym(r_cut);
+
+	vd.parallel_for_domain_cells(NN,[&](vect_dist_key_dx p)
+	{
+		vd.getPropNC<1>(p) += 1;
+	});
+
+	bool match = true;
+	auto it3 = vd.getDomainIterator();
+
+	while (it3.isNext())
+	{
+		auto p = it3.get();
+
+		match &= vd.getProp<0>(p) == vd.getPos(p)[0] + vd.getPos(p)[1];
+		match &= vd.getProp<1>(p) == 2;
+
+		++it3;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
 BOOST_AUTO_TEST_CASE( vector_dist_particle_NN_update_with_limit )
 {
 	Vcluster<> & v_cl = create_vcluster();
@@ -479,3 +570,239 @@ BOOST_AUTO_TEST_CASE( vector_dist_particle_getCellListSym_with_div )
 
 	BOOST_REQUIRE_EQUAL(match,true);
 }
+
+BOOST_AUTO_TEST_CASE( vector_dist_managed_verlet_test )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	if (v_cl.getProcessingUnits() > 12)
+		return;
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+	std::uniform_real_distribution<float> ud_m(-0.005f, 0.005f);
+
+	long int k = 1000 * v_cl.getProcessingUnits();
+
+	print_test_v("Testing 3D managed Verlet list k= ",k);
+	BOOST_TEST_CHECKPOINT( "Testing 3D managed Verlet list k= " << k );
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	float r_cut = 0.1;
+	float skin = 0.04;
+
+	// ghost
+	Ghost<3,float> ghost(r_cut + skin);
+
+	vector_dist<3,float, aggregate<float> > vd(k,box,bc,ghost);
+
+	auto it = vd.getDomainIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		vd.getPos(key)[0] = ud(eg);
+		vd.getPos(key)[1] = ud(eg);
+		vd.getPos(key)[2] = ud(eg);
+
+		++it;
+	}
+
+	vd.map();
+	vd.ghost_get<>();
+
+	vd.setManagedVerlet(r_cut,skin);
+
+	size_t n_rebuild = 0;
+	bool match = true;
+
+	for (size_t step = 0 ; step < 8 ; step++)
+	{
+		if (vd.managedVerletRebuildRequired() == true)
+		{
+			vd.map();
+			vd.ghost_get<>();
+			n_rebuild++;
+		}
+		else
+		{vd.ghost_get<>(SKIP_LABELLING);}
+
+		auto & ver = vd.getManagedVerlet();
+
+		// reference
+		auto NN = vd.getCellList(r_cut);
+
+		auto it2 = vd.getDomainIterator();
+
+		while (it2.isNext())
+		{
+			auto p = it2.get();
+			Point<3,float> xp = vd.getPosRead(p);
+
+			size_t n_ver = 0;
+			auto Nv = ver.getNNIterator(p.getKey());
+			while (Nv.isNext())
+			{
+				auto q = Nv.get();
+				if (q != p.getKey() && xp.distance2(vd.getPosRead(q)) < r_cut*r_cut)
+				{n_ver++;}
+
+				++Nv;
+			}
+
+			size_t n_cl = 0;
+			auto Nc = NN.getNNIterator(NN.getCell(xp));
+			while (Nc.isNext())
+			{
+				auto q = Nc.get();
+				if (q != p.getKey() && xp.distance2(vd.getPosRead(q)) < r_cut*r_cut)
+				{n_cl++;}
+
+				++Nc;
+			}
+
+			match &= n_ver == n_cl;
+
+			++it2;
+		}
+
+		// move the particles less than skin/2 in total every step
+		auto it3 = vd.getDomainIterator();
+
+		while (it3.isNext())
+		{
+			auto p = it3.get();
+
+			vd.getPosWrite(p)[0] += ud_m(eg);
+			vd.getPosWrite(p)[1] += ud_m(eg);
+			vd.getPosWrite(p)[2] += ud_m(eg);
+
+			++it3;
+		}
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+
+	// the first build plus at least one step that reused the list
+	BOOST_REQUIRE(n_rebuild >= 1);
+	BOOST_REQUIRE(n_rebuild < 8);
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_for_each_pair_test )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	if (v_cl.getProcessingUnits() > 12)
+		return;
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<double> ud(0.0, 1.0);
+
+	long int k = 2000 * v_cl.getProcessingUnits();
+
+	print_test_v("Testing 3D for_each_pair k= ",k);
+	BOOST_TEST_CHECKPOINT( "Testing 3D for_each_pair k= " << k );
+
+	Box<3,double> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	double r_cut = 0.1;
+
+	// ghost
+	Ghost<3,double> ghost(r_cut);
+
+	// scalar result, packet result
+	vector_dist<3,double, aggregate<double[4],double[4]> > vd(k,box,bc,ghost);
+
+	auto it = vd.getDomainIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		vd.getPos(key)[0] = ud(eg);
+		vd.getPos(key)[1] = ud(eg);
+		vd.getPos(key)[2] = ud(eg);
+
+		for (size_t i = 0 ; i < 4 ; i++)
+		{
+			vd.getProp<0>(key)[i] = 0.0;
+			vd.getProp<1>(key)[i] = 0.0;
+		}
+
+		++it;
+	}
+
+	vd.map();
+	vd.ghost_get<>();
+
+	auto NN = vd.getCellList(r_cut);
+
+	auto it2 = vd.getDomainIterator();
+
+	while (it2.isNext())
+	{
+		auto p = it2.get();
+		Point<3,double> xp = vd.getPosRead(p);
+
+		auto Np = NN.getNNIterator(NN.getCell(xp));
+
+		while (Np.isNext())
+		{
+			auto q = Np.get();
+
+			Point<3,double> dx = xp - vd.getPosRead(q);
+			double r2 = norm2(dx);
+
+			if (q != p.getKey() && r2 < r_cut*r_cut)
+			{
+				vd.getProp<0>(p)[0] += dx.get(0) / r2;
+				vd.getProp<0>(p)[1] += dx.get(1) / r2;
+				vd.getProp<0>(p)[2] += dx.get(2) / r2;
+				vd.getProp<0>(p)[3] += 1.0;
+			}
+
+			++Np;
+		}
+
+		++it2;
+	}
+
+	vd.for_each_pair(NN,r_cut,[&](size_t p, pair_packet<3,double> & pk)
+	{
+		double acc[4] = {0.0,0.0,0.0,0.0};
+
+		for (size_t l = 0 ; l < pk.width ; l++)
+		{
+			acc[0] += pk.mask[l] * pk.dx[0][l] / pk.r2[l];
+			acc[1] += pk.mask[l] * pk.dx[1][l] / pk.r2[l];
+			acc[2] += pk.mask[l] * pk.dx[2][l] / pk.r2[l];
+			acc[3] += pk.mask[l];
+		}
+
+		for (size_t i = 0 ; i < 4 ; i++)
+		{vd.getProp<1>(p)[i] += acc[i];}
+	});
+
+	bool match = true;
+	auto it3 = vd.getDomainIterator();
+
+	while (it3.isNext())
+	{
+		auto p = it3.get();
+
+		for (size_t i = 0 ; i < 4 ; i++)
+		{match &= fabs(vd.getProp<0>(p)[i] - vd.getProp<1>(p)[i]) < 1e-6;}
+
+		++it3;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
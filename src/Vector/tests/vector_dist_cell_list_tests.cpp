@@ -174,6 +174,7 @@ BOOST_AUTO_TEST_CASE( vector_dist_reorder_2d_test )
 {
 	test_reorder_sfc(reorder_opt::HILBERT);
 	test_reorder_sfc(reorder_opt::LINEAR);
+	test_reorder_sfc(reorder_opt::MORTON);
 }
 
 BOOST_AUTO_TEST_CASE( vector_dist_reorder_cl_test )
@@ -181,6 +182,379 @@ BOOST_AUTO_TEST_CASE( vector_dist_reorder_cl_test )
 	test_reorder_cl();
 }
 
+template<unsigned int dim> void test_hilbert_key_adjacency(unsigned int m)
+{
+	size_t n_cell = (size_t)1 << (dim*m);
+	std::vector<grid_key_dx<dim>> inv(n_cell);
+	std::vector<bool> used(n_cell,false);
+
+	size_t sz[dim];
+	for (size_t i = 0 ; i < dim ; i++)
+	{sz[i] = (size_t)1 << m;}
+
+	grid_sm<dim,void> gs(sz);
+	grid_key_dx_iterator<dim> it(gs);
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		size_t x[dim];
+		for (size_t i = 0 ; i < dim ; i++)
+		{x[i] = key.get(i);}
+
+		size_t h = sfc_hilbert_key<dim>(x,m);
+
+		BOOST_REQUIRE(h < n_cell);
+		BOOST_REQUIRE_EQUAL(used[h],false);
+
+		used[h] = true;
+		inv[h] = key;
+
+		++it;
+	}
+
+	// two consecutive cells on the curve must be neighborhood
+	for (size_t h = 1 ; h < n_cell ; h++)
+	{
+		size_t dist = 0;
+		for (size_t i = 0 ; i < dim ; i++)
+		{dist += std::abs(inv[h].get(i) - inv[h-1].get(i));}
+
+		BOOST_REQUIRE_EQUAL(dist,1ul);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_sfc_keys_and_radix_sort_test )
+{
+	test_hilbert_key_adjacency<2>(4);
+	test_hilbert_key_adjacency<3>(3);
+
+	// Morton key of the cell (x,y,z) interleave the bits with x the least significant
+	size_t x[3] = {1,2,3};
+	BOOST_REQUIRE_EQUAL(sfc_morton_key<3>(x,2),0x35ul);
+
+	// radix sort must be stable and equivalent to std::stable_sort
+	std::default_random_engine eg;
+	std::uniform_int_distribution<size_t> ud(0,(1ul << 20) - 1);
+
+	sfc_sort_buffers buf;
+	std::vector<std::pair<size_t,size_t>> ref;
+
+	size_t n = 100000;
+	buf.key.resize(n);
+	buf.id.resize(n);
+
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		// few bits in the low part to have many equal keys
+		buf.key.get(i) = ud(eg) & ~0xF0ul;
+		buf.id.get(i) = i;
+
+		ref.push_back(std::make_pair(buf.key.get(i),i));
+	}
+
+	std::stable_sort(ref.begin(),ref.end(),[](const std::pair<size_t,size_t> & a, const std::pair<size_t,size_t> & b){return a.first < b.first;});
+
+	sfc_radix_sort(buf,20);
+
+	bool match = true;
+	for (size_t i = 0 ; i < n ; i++)
+	{
+		match &= buf.key.get(i) == ref[i].first;
+		match &= buf.id.get(i) == ref[i].second;
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_reorder_keep_particles_test )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+
+	size_t k = 50000 * v_cl.getProcessingUnits();
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={NON_PERIODIC,NON_PERIODIC,NON_PERIODIC};
+
+	vector_dist<3,float, aggregate<float,float> > vd(k,box,bc,Ghost<3,float>(0.01));
+
+	auto it = vd.getDomainIterator();
+
+	while (it.isNext())
+	{
+		auto p = it.get();
+
+		vd.getPosWrite(p)[0] = ud(eg);
+		vd.getPosWrite(p)[1] = ud(eg);
+		vd.getPosWrite(p)[2] = ud(eg);
+
+		++it;
+	}
+
+	vd.map();
+
+	auto it2 = vd.getDomainIterator();
+
+	while (it2.isNext())
+	{
+		auto p = it2.get();
+
+		vd.getPropWrite<0>(p) = vd.getPosRead(p)[0] + vd.getPosRead(p)[1] + vd.getPosRead(p)[2];
+		vd.getPropWrite<1>(p) = vd.getPosRead(p)[0] * vd.getPosRead(p)[1];
+
+		++it2;
+	}
+
+	size_t n_before = vd.size_local();
+
+	for (reorder_opt opt : {reorder_opt::HILBERT,reorder_opt::LINEAR,reorder_opt::MORTON})
+	{
+		vd.reorder(5,opt);
+
+		BOOST_REQUIRE_EQUAL(vd.size_local(),n_before);
+
+		bool match = true;
+		auto it3 = vd.getDomainIterator();
+
+		while (it3.isNext())
+		{
+			auto p = it3.get();
+
+			match &= vd.getPropRead<0>(p) == vd.getPosRead(p)[0] + vd.getPosRead(p)[1] + vd.getPosRead(p)[2];
+			match &= vd.getPropRead<1>(p) == vd.getPosRead(p)[0] * vd.getPosRead(p)[1];
+
+			++it3;
+		}
+
+		BOOST_REQUIRE_EQUAL(match,true);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_auto_reorder_test )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+	std::uniform_real_distribution<float> step(-0.01f, 0.01f);
+
+	size_t k = 20000 * v_cl.getProcessingUnits();
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	vector_dist<3,float, aggregate<float> > vd(k,box,bc,Ghost<3,float>(0.05));
+
+	auto it = vd.getDomainIterator();
+
+	while (it.isNext())
+	{
+		auto p = it.get();
+
+		vd.getPosWrite(p)[0] = ud(eg);
+		vd.getPosWrite(p)[1] = ud(eg);
+		vd.getPosWrite(p)[2] = ud(eg);
+		vd.getPropWrite<0>(p) = 1.0;
+
+		++it;
+	}
+
+	// the particles are not ordered
+	double metric_random = vd.getLocalityMetric();
+
+	vd.setAutoReorder(5,reorder_opt::MORTON);
+
+	// the first map reorder
+	vd.map();
+
+	BOOST_REQUIRE(vd.getLocalityMetric() < metric_random);
+
+	for (size_t i = 0 ; i < 20 ; i++)
+	{
+		auto it2 = vd.getDomainIterator();
+
+		while (it2.isNext())
+		{
+			auto p = it2.get();
+
+			vd.getPosWrite(p)[0] += step(eg);
+			vd.getPosWrite(p)[1] += step(eg);
+			vd.getPosWrite(p)[2] += step(eg);
+
+			++it2;
+		}
+
+		// a reorder invalidate the lazy map information, the processors must still agree
+		vd.map(MAP_LAZY);
+	}
+
+	// the other migration paths reorder too (setAutoReorder reset the policy, so the next migration reorder)
+	for (size_t path = 0 ; path < 2 ; path++)
+	{
+		auto it2 = vd.getDomainIterator();
+
+		while (it2.isNext())
+		{
+			auto p = it2.get();
+
+			vd.getPosWrite(p)[0] = ud(eg);
+			vd.getPosWrite(p)[1] = ud(eg);
+			vd.getPosWrite(p)[2] = ud(eg);
+
+			++it2;
+		}
+
+		vd.setAutoReorder(5,reorder_opt::MORTON);
+
+		if (path == 0)
+		{
+			vd.Imap();
+			vd.map_wait();
+		}
+		else
+		{
+			vd.map_and_ghost_get();
+
+			// the ghost survive the reorder
+			size_t n_ghost = vd.size_local_with_ghost() - vd.size_local();
+			v_cl.sum(n_ghost);
+			v_cl.execute();
+
+			BOOST_REQUIRE(n_ghost != 0);
+		}
+
+		BOOST_REQUIRE(vd.getLocalityMetric() < metric_random);
+	}
+
+	vd.disableAutoReorder();
+
+	// no particle is lost
+	size_t cnt = vd.size_local();
+	float sum = 0.0;
+
+	auto it3 = vd.getDomainIterator();
+	while (it3.isNext())
+	{
+		sum += vd.getPropRead<0>(it3.get());
+		++it3;
+	}
+
+	v_cl.sum(cnt);
+	v_cl.sum(sum);
+	v_cl.execute();
+
+	BOOST_REQUIRE_EQUAL(cnt,k);
+	BOOST_REQUIRE_EQUAL(sum,(float)k);
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_incremental_cell_list_test )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+	std::uniform_real_distribution<float> step(-0.005f, 0.005f);
+
+	size_t k = 20000 * v_cl.getProcessingUnits();
+	float r_cut = 0.05;
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	typedef CellList<3,float,Mem_fast<>,shift<3,float>> CellL;
+
+	vector_dist<3,float, aggregate<float> > vd(k,box,bc,Ghost<3,float>(r_cut));
+
+	auto it = vd.getDomainIterator();
+
+	while (it.isNext())
+	{
+		auto p = it.get();
+
+		vd.getPosWrite(p)[0] = ud(eg);
+		vd.getPosWrite(p)[1] = ud(eg);
+		vd.getPosWrite(p)[2] = ud(eg);
+
+		++it;
+	}
+
+	vd.map();
+	vd.ghost_get<>();
+
+	auto NN = vd.getCellList<CellL>(r_cut);
+
+	for (size_t i = 0 ; i < 10 ; i++)
+	{
+		auto it2 = vd.getDomainIterator();
+
+		while (it2.isNext())
+		{
+			auto p = it2.get();
+
+			vd.getPosWrite(p)[0] += step(eg);
+			vd.getPosWrite(p)[1] += step(eg);
+			vd.getPosWrite(p)[2] += step(eg);
+
+			++it2;
+		}
+
+		// every three steps the particles migrate and the update is a full reconstruction
+		if (i % 3 == 2)
+		{vd.map();}
+
+		vd.ghost_get<>();
+
+		// a new cell-list in the same object, the incremental update must not reuse the old information
+		if (i == 4)
+		{NN = vd.getCellList<CellL>(r_cut);}
+
+		// constructing another cell-list does not stop the incremental update of NN
+		auto NN2 = vd.getCellList<CellL>(0.5f*r_cut);
+		BOOST_REQUIRE(NN2.getGrid().size() != 0);
+
+		size_t n_moved = vd.updateCellListIncremental(NN);
+
+		// the particles move less than a cell, only a fraction of them change cell (a full reconstruction
+		// return the number of particles)
+		if (i != 0 && i % 3 != 2 && i != 4)
+		{BOOST_REQUIRE(n_moved < vd.size_local() / 2);}
+
+		// the content of the cells must be the one of the actual positions, the order inside a cell can be different
+		std::vector<std::vector<size_t>> ref(NN.getGrid().size());
+
+		for (size_t j = 0 ; j < vd.size_local_with_ghost() ; j++)
+		{
+			Point<3,float> xp = vd.getPosRead(j);
+			ref[NN.getCell(xp)].push_back(j);
+		}
+
+		bool match = true;
+		for (size_t c = 0 ; c < NN.getGrid().size() ; c++)
+		{
+			std::vector<size_t> e1;
+
+			for (size_t j = 0 ; j < NN.getNelements(c) ; j++)
+			{e1.push_back(NN.get(c,j));}
+
+			std::sort(e1.begin(),e1.end());
+
+			match &= e1 == ref[c];
+		}
+
+		BOOST_REQUIRE_EQUAL(match,true);
+	}
+}
+
 BOOST_AUTO_TEST_CASE( vector_dist_cl_random_vs_hilb_forces_test )
 {
 	Vcluster<> & v_cl = create_vcluster();
@@ -1734,6 +2108,290 @@ BOOST_AUTO_TEST_CASE( vector_dist_symmetric_crs_verlet_list_partit )
 	test_vd_symmetric_crs_verlet<VERLET_MEMMW(3,float)>();
 }
 
+BOOST_AUTO_TEST_CASE( vector_dist_symmetric_crs_verlet_list_parallel )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	if (v_cl.getProcessingUnits() > 24)
+		return;
+
+	float L = 1000.0;
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<float> ud(-L,L);
+
+	long int k = 4096 * v_cl.getProcessingUnits();
+
+	print_test_v("Testing 3D periodic vector multi-thread symmetric crs verlet-list k=",k);
+	BOOST_TEST_CHECKPOINT( "Testing 3D periodic vector multi-thread symmetric crs verlet-list k=" << k );
+
+	Box<3,float> box({-L,-L,-L},{L,L,L});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	float r_cut = 100.0;
+
+	// ghost
+	Ghost<3,float> ghost(r_cut);
+	Ghost<3,float> ghost2(r_cut);
+	ghost2.setLow(0,0.0);
+	ghost2.setLow(1,0.0);
+	ghost2.setLow(2,0.0);
+
+	// number of neighborhood, sum of the distance vectors
+	typedef aggregate<float,float[3]> part_prop;
+
+	vector_dist<3,float, part_prop > vd(k,box,bc,ghost,BIND_DEC_TO_GHOST);
+	vector_dist<3,float, part_prop > vd2(k,box,bc,ghost2,BIND_DEC_TO_GHOST);
+
+	auto it = vd.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		vd.getPos(key)[0] = ud(eg);
+		vd.getPos(key)[1] = ud(eg);
+		vd.getPos(key)[2] = ud(eg);
+
+		vd2.getPos(key)[0] = vd.getPos(key)[0];
+		vd2.getPos(key)[1] = vd.getPos(key)[1];
+		vd2.getPos(key)[2] = vd.getPos(key)[2];
+
+		++it;
+	}
+
+	vd.map();
+	vd2.map();
+
+	vd.ghost_get<>();
+	vd2.ghost_get<>();
+
+	// reference with the full Verlet list
+	auto NN = vd.getVerlet(r_cut);
+	auto p_it = vd.getDomainIterator();
+
+	while (p_it.isNext())
+	{
+		auto p = p_it.get();
+
+		Point<3,float> xp = vd.getPosRead(p);
+
+		vd.getPropWrite<0>(p) = 0;
+		vd.getPropWrite<1>(p)[0] = 0;
+		vd.getPropWrite<1>(p)[1] = 0;
+		vd.getPropWrite<1>(p)[2] = 0;
+
+		auto Np = NN.getNNIterator(p.getKey());
+
+		while (Np.isNext())
+		{
+			auto q = Np.get();
+
+			Point<3,float> r = xp - vd.getPosRead(q);
+
+			if (p.getKey() != q && r.norm() < r_cut)
+			{
+				vd.getPropWrite<0>(p) += 1;
+				vd.getPropWrite<1>(p)[0] += r.get(0);
+				vd.getPropWrite<1>(p)[1] += r.get(1);
+				vd.getPropWrite<1>(p)[2] += r.get(2);
+			}
+
+			++Np;
+		}
+
+		++p_it;
+	}
+
+	// multi-thread symmetric
+	auto NN2 = vd2.getVerletCrs(r_cut);
+
+	auto itg = vd2.getDomainAndGhostIterator();
+
+	while (itg.isNext())
+	{
+		auto p = itg.get();
+
+		vd2.getPropWrite<0>(p) = 0;
+		vd2.getPropWrite<1>(p)[0] = 0;
+		vd2.getPropWrite<1>(p)[1] = 0;
+		vd2.getPropWrite<1>(p)[2] = 0;
+
+		++itg;
+	}
+
+	// the second time the buffers of the previous call are reused, they must be clean
+	for (size_t k = 0 ; k < 2 ; k++)
+	{
+		for (size_t i = 0 ; i < vd2.size_local_with_ghost() ; i++)
+		{vd2.getPropWrite<0>(i) = 0;}
+
+		vd2.parallel_for_CRS<0>(NN2,[&](size_t p, thread_acc_view<float,1> & acc)
+		{
+			Point<3,float> xp = vd2.getPosNC(p);
+
+			auto Np = NN2.template getNNIterator<NO_CHECK>(p);
+
+			while (Np.isNext())
+			{
+				auto q = Np.get();
+
+				if (p != q && (xp - vd2.getPosNC(q)).norm() < r_cut)
+				{
+					acc.get(p)[0] += 1;
+					acc.get(q)[0] += 1;
+				}
+
+				++Np;
+			}
+		});
+	}
+
+	vd2.parallel_for_CRS<1>(NN2,[&](size_t p, thread_acc_view<float,3> & acc)
+	{
+		Point<3,float> xp = vd2.getPosNC(p);
+
+		auto Np = NN2.template getNNIterator<NO_CHECK>(p);
+
+		while (Np.isNext())
+		{
+			auto q = Np.get();
+
+			Point<3,float> r = xp - vd2.getPosNC(q);
+
+			if (p != q && r.norm() < r_cut)
+			{
+				for (size_t i = 0 ; i < 3 ; i++)
+				{
+					acc.get(p)[i] += r.get(i);
+					acc.get(q)[i] -= r.get(i);
+				}
+			}
+
+			++Np;
+		}
+	});
+
+	vd2.ghost_put<add_,0,1>();
+
+	bool ret = true;
+	auto p_it3 = vd.getDomainIterator();
+
+	while (p_it3.isNext())
+	{
+		auto p = p_it3.get();
+
+		ret &= vd2.getPropRead<0>(p) == vd.getPropRead<0>(p);
+
+		for (size_t i = 0 ; i < 3 ; i++)
+		{ret &= fabs(vd2.getPropRead<1>(p)[i] - vd.getPropRead<1>(p)[i]) < 0.1;}
+
+		++p_it3;
+	}
+
+	BOOST_REQUIRE_EQUAL(ret,true);
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_thread_acc_reduced_range )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	vector_dist<3,float, aggregate<float> > vd(20000,box,bc,Ghost<3,float>(0.02));
+
+	auto it = vd.getDomainIterator();
+	while (it.isNext())
+	{
+		auto p = it.get();
+
+		vd.getPosWrite(p)[0] = ud(eg);
+		vd.getPosWrite(p)[1] = ud(eg);
+		vd.getPosWrite(p)[2] = ud(eg);
+
+		++it;
+	}
+
+	vd.map();
+	vd.ghost_get<>();
+
+	size_t g_m = vd.size_local();
+	size_t n = vd.size_local_with_ghost();
+	size_t n_ghost = n - g_m;
+
+	for (size_t i = 0 ; i < n ; i++)
+	{vd.getPropWrite<0>(i) = 0;}
+
+	// every thread (called one after the other) accumulate on its own chunk of domain particles, and on some
+	// ghost particles, that are far in memory
+	const size_t n_thr = 4;
+
+	thread_acc_mem mem;
+	vector_dist_thread_acc<float> acc(mem);
+	acc.init(n_thr,n);
+
+	for (size_t t = 0 ; t < n_thr ; t++)
+	{
+		auto acc_t = acc.getView(t);
+
+		for (size_t p = g_m*t/n_thr ; p < g_m*(t+1)/n_thr ; p++)
+		{
+			acc_t.get(p)[0] += 1;
+
+			if (n_ghost != 0 && p % 64 == 0)
+			{acc_t.get(g_m + (p / 64) % n_ghost)[0] += 1;}
+		}
+	}
+
+	acc.reduce<0>(vd.getPropVector());
+
+	// every domain particle received one contribution
+	bool ret = true;
+	float sum_ghost = 0;
+	for (size_t i = 0 ; i < g_m ; i++)
+	{ret &= vd.getPropRead<0>(i) == 1;}
+	for (size_t i = g_m ; i < n ; i++)
+	{sum_ghost += vd.getPropRead<0>(i);}
+
+	BOOST_REQUIRE_EQUAL(ret,true);
+
+	size_t n_ghost_acc = 0;
+	for (size_t p = 0 ; p < g_m ; p++)
+	{n_ghost_acc += (n_ghost != 0 && p % 64 == 0);}
+
+	BOOST_REQUIRE_EQUAL(sum_ghost,(float)n_ghost_acc);
+
+	// only the blocks accessed are reduced: the domain once (plus the blocks shared between two threads) and the
+	// blocks of the ghost accessed by every thread, not the full range of particles for every thread
+	size_t blk = (size_t)1 << THREAD_ACC_BLK_SHIFT;
+	size_t ghost_acc = std::min(n_ghost,g_m / n_thr / 64 + 1);
+	size_t bound = g_m + 2*n_thr*blk + n_thr*(ghost_acc + 3*blk);
+
+	BOOST_REQUIRE(acc.n_reduced <= bound);
+
+	// the buffers are clean for the next accumulation
+	for (size_t i = 0 ; i < n ; i++)
+	{vd.getPropWrite<0>(i) = 0;}
+
+	acc.init(n_thr,n);
+	acc.reduce<0>(vd.getPropVector());
+
+	BOOST_REQUIRE_EQUAL(acc.n_reduced,0ul);
+
+	for (size_t i = 0 ; i < n ; i++)
+	{ret &= vd.getPropRead<0>(i) == 0;}
+
+	BOOST_REQUIRE_EQUAL(ret,true);
+}
+
 BOOST_AUTO_TEST_CASE( vector_dist_checking_unloaded_processors )
 {
 	Vcluster<> & v_cl = create_vcluster();
@@ -11,6 +11,8 @@
 #include "config.h"
 
 #include <random>
+#include <array>
+#include <unordered_map>
 #include "Vector/vector_dist.hpp"
 #include "data_type/aggregate.hpp"
 #include "vector_dist_util_unit_tests.hpp"
@@ -824,6 +826,719 @@ BOOST_AUTO_TEST_CASE( vector_dist_periodic_test_random_walk_local_map )
 	test_random_walk(MAP_LOCAL);
 }
 
+BOOST_AUTO_TEST_CASE( vector_dist_periodic_test_random_walk_send_arena )
+{
+	test_random_walk(MAP_SEND_ARENA);
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_periodic_test_random_walk_lazy_map )
+{
+	test_random_walk(MAP_LAZY);
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_lazy_map_add_one_processor )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+	Ghost<3,float> ghost(0.05);
+
+	size_t k = 4096 * v_cl.getProcessingUnits();
+
+	vector_dist<3,float, Point_test<float> > vd(k,box,bc,ghost);
+
+	auto it = vd.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		vd.getPos(key)[0] = ud(eg);
+		vd.getPos(key)[1] = ud(eg);
+		vd.getPos(key)[2] = ud(eg);
+
+		++it;
+	}
+
+	vd.map(MAP_LAZY);
+
+	for (size_t j = 0 ; j < 3 ; j++)
+	{
+		// only one processor invalidate its lazy information, the others must follow it
+		if (v_cl.getProcessUnitID() == 0)
+		{
+			vd.add();
+			vd.getLastPos()[0] = ud(eg);
+			vd.getLastPos()[1] = ud(eg);
+			vd.getLastPos()[2] = ud(eg);
+		}
+		k++;
+
+		vd.map(MAP_LAZY);
+
+		size_t cnt = total_n_part_lc(vd,bc);
+		BOOST_REQUIRE_EQUAL(k,cnt);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_periodic_test_random_walk_async_map )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	std::srand(v_cl.getProcessUnitID());
+	std::default_random_engine eg;
+	std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+
+	size_t k = 4096 * v_cl.getProcessingUnits();
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	// factor
+	float factor = pow(create_vcluster().getProcessingUnits()/2.0f,1.0f/3.0f);
+
+	// ghost
+	Ghost<3,float> ghost(0.01 / factor);
+
+	// Distributed vector
+	vector_dist<3,float, Point_test<float> > vd(k,box,bc,ghost);
+
+	auto it = vd.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		vd.getPos(key)[0] = ud(eg);
+		vd.getPos(key)[1] = ud(eg);
+		vd.getPos(key)[2] = ud(eg);
+
+		++it;
+	}
+
+	vd.map();
+
+	for (size_t j = 0 ; j < 4 ; j++)
+	{
+		auto it = vd.getDomainIterator();
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			vd.getPos(key)[0] += 0.02 * ud(eg);
+			vd.getPos(key)[1] += 0.02 * ud(eg);
+			vd.getPos(key)[2] += 0.02 * ud(eg);
+
+			++it;
+		}
+
+		vd.Imap();
+
+		// While the communication is in flight the particles we have are local
+		bool noOut = true;
+		auto it2 = vd.getDomainIterator();
+
+		while (it2.isNext())
+		{
+			auto key = it2.get();
+
+			noOut &= vd.getDecomposition().isLocal(vd.getPos(key));
+
+			++it2;
+		}
+
+		BOOST_REQUIRE_EQUAL(noOut,true);
+
+		vd.map_wait();
+
+		vd.ghost_get<0>();
+
+		// Count the local particles and check that the total number is consistent
+		size_t cnt = total_n_part_lc(vd,bc);
+
+		BOOST_REQUIRE_EQUAL(k,cnt);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_periodic_test_map_and_ghost_get )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	std::srand(v_cl.getProcessUnitID());
+	std::default_random_engine eg;
+	std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+
+	size_t k = 4096 * v_cl.getProcessingUnits();
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	// factor
+	float factor = pow(create_vcluster().getProcessingUnits()/2.0f,1.0f/3.0f);
+
+	// ghost
+	Ghost<3,float> ghost(0.05 / factor);
+
+	// Two distributed vector with the same particles
+	vector_dist<3,float, Point_test<float> > vd(k,box,bc,ghost);
+	vector_dist<3,float, Point_test<float> > vd2(vd.getDecomposition(),k);
+
+	auto it = vd.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		vd.getPos(key)[0] = ud(eg);
+		vd.getPos(key)[1] = ud(eg);
+		vd.getPos(key)[2] = ud(eg);
+		vd.getProp<0>(key) = v_cl.getProcessUnitID()*k + key.getKey();
+
+		vd2.getPos(key)[0] = vd.getPos(key)[0];
+		vd2.getPos(key)[1] = vd.getPos(key)[1];
+		vd2.getPos(key)[2] = vd.getPos(key)[2];
+		vd2.getProp<0>(key) = vd.getProp<0>(key);
+
+		++it;
+	}
+
+	for (size_t j = 0 ; j < 3 ; j++)
+	{
+		vd.map();
+		vd.ghost_get<0>();
+
+		vd2.map_and_ghost_get();
+
+		BOOST_REQUIRE_EQUAL(vd.size_local(),vd2.size_local());
+		BOOST_REQUIRE_EQUAL(vd.size_local_with_ghost(),vd2.size_local_with_ghost());
+
+		// the ghost must contain the same particles (in general in a different order)
+		std::vector<std::array<float,4>> g1;
+		std::vector<std::array<float,4>> g2;
+
+		auto itg = vd.getGhostIterator();
+		while (itg.isNext())
+		{
+			auto key = itg.get();
+			g1.push_back({vd.getPos(key)[0],vd.getPos(key)[1],vd.getPos(key)[2],vd.getProp<0>(key)});
+			++itg;
+		}
+
+		auto itg2 = vd2.getGhostIterator();
+		while (itg2.isNext())
+		{
+			auto key = itg2.get();
+			g2.push_back({vd2.getPos(key)[0],vd2.getPos(key)[1],vd2.getPos(key)[2],vd2.getProp<0>(key)});
+			++itg2;
+		}
+
+		std::sort(g1.begin(),g1.end());
+		std::sort(g2.begin(),g2.end());
+
+		BOOST_REQUIRE(g1 == g2);
+
+		// move the particles of both in the same way
+		auto it2 = vd.getDomainIterator();
+		while (it2.isNext())
+		{
+			auto key = it2.get();
+
+			vd.getPos(key)[0] += 0.02 * ud(eg);
+			vd.getPos(key)[1] += 0.02 * ud(eg);
+			vd.getPos(key)[2] += 0.02 * ud(eg);
+
+			++it2;
+		}
+
+		// the domain particles of vd and vd2 are in general in different order, so we move them by id
+		std::unordered_map<size_t,Point<3,float>> mv;
+		auto it3 = vd.getDomainIterator();
+		while (it3.isNext())
+		{
+			auto key = it3.get();
+			Point<3,float> p = vd.getPos(key);
+			mv[(size_t)vd.getProp<0>(key)] = p;
+			++it3;
+		}
+
+		auto it4 = vd2.getDomainIterator();
+		while (it4.isNext())
+		{
+			auto key = it4.get();
+			Point<3,float> & p = mv[(size_t)vd2.getProp<0>(key)];
+
+			vd2.getPos(key)[0] = p.get(0);
+			vd2.getPos(key)[1] = p.get(1);
+			vd2.getPos(key)[2] = p.get(2);
+
+			++it4;
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_periodic_test_ghost_get_skin )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+
+	size_t k = 16384 * v_cl.getProcessingUnits();
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	// factor
+	float factor = pow(create_vcluster().getProcessingUnits()/2.0f,1.0f/3.0f);
+
+	// ghost
+	float r_cut = 0.05 / factor;
+	Ghost<3,float> ghost(r_cut);
+
+	vector_dist<3,float, Point_test<float> > vd(k,box,bc,ghost);
+	vector_dist<3,float, Point_test<float> > vd2(vd.getDecomposition(),k);
+
+	auto it = vd.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		vd.getPos(key)[0] = ud(eg);
+		vd.getPos(key)[1] = ud(eg);
+		vd.getPos(key)[2] = ud(eg);
+		vd.getProp<0>(key) = key.getKey();
+
+		vd2.getPos(key)[0] = vd.getPos(key)[0];
+		vd2.getPos(key)[1] = vd.getPos(key)[1];
+		vd2.getPos(key)[2] = vd.getPos(key)[2];
+		vd2.getProp<0>(key) = key.getKey();
+
+		++it;
+	}
+
+	vd.map();
+	vd2.map();
+
+	auto cl = vd2.getCellList(r_cut);
+
+	for (size_t j = 0 ; j < 2 ; j++)
+	{
+		vd.ghost_get<0>();
+		vd2.ghost_get_skin<0>(cl);
+
+		// The result must be identical, including the order of the particles
+		BOOST_REQUIRE_EQUAL(vd.size_local_with_ghost(),vd2.size_local_with_ghost());
+
+		bool match = true;
+		for (size_t i = vd.size_local() ; i < vd.size_local_with_ghost() ; i++)
+		{
+			match &= vd.getPos(i)[0] == vd2.getPos(i)[0];
+			match &= vd.getPos(i)[1] == vd2.getPos(i)[1];
+			match &= vd.getPos(i)[2] == vd2.getPos(i)[2];
+			match &= vd.getProp<0>(i) == vd2.getProp<0>(i);
+		}
+
+		BOOST_REQUIRE_EQUAL(match,true);
+	}
+
+	// A ghost_get_skin that return without communication must not leave the candidates for the next labelling
+	vd2.ghost_get_skin<0>(cl,WITH_POSITION | GHOST_AUTO_REUSE);
+
+	auto it2 = vd.getDomainIterator();
+
+	while (it2.isNext())
+	{
+		auto key = it2.get();
+
+		vd.getPosWrite(key)[0] += 0.1f * ud(eg);
+		vd2.getPosWrite(key)[0] = vd.getPosRead(key)[0];
+
+		++it2;
+	}
+
+	vd.map();
+	vd2.map();
+
+	vd.ghost_get<0>();
+	vd2.ghost_get<0>();
+
+	BOOST_REQUIRE_EQUAL(vd.size_local_with_ghost(),vd2.size_local_with_ghost());
+
+	bool match = true;
+	for (size_t i = vd.size_local() ; i < vd.size_local_with_ghost() ; i++)
+	{
+		match &= vd.getPos(i)[0] == vd2.getPos(i)[0];
+		match &= vd.getPos(i)[1] == vd2.getPos(i)[1];
+		match &= vd.getPos(i)[2] == vd2.getPos(i)[2];
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_periodic_test_auto_skip_labelling )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+
+	size_t k = 4096 * v_cl.getProcessingUnits();
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	// ghost
+	Ghost<3,float> ghost(0.05);
+
+	vector_dist<3,float, Point_test<float> > vd(k,box,bc,ghost);
+	vector_dist<3,float, Point_test<float> > vd2(vd.getDecomposition(),k);
+
+	auto it = vd.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		vd.getPosWrite(key)[0] = ud(eg);
+		vd.getPosWrite(key)[1] = ud(eg);
+		vd.getPosWrite(key)[2] = ud(eg);
+
+		vd2.getPosWrite(key)[0] = vd.getPosRead(key)[0];
+		vd2.getPosWrite(key)[1] = vd.getPosRead(key)[1];
+		vd2.getPosWrite(key)[2] = vd.getPosRead(key)[2];
+
+		++it;
+	}
+
+	vd.map();
+	vd2.map();
+
+	for (size_t j = 0 ; j < 4 ; j++)
+	{
+		// only the properties change, vd reuse the labelling of the previous ghost_get
+		auto it2 = vd.getDomainIterator();
+
+		while (it2.isNext())
+		{
+			auto key = it2.get();
+
+			vd.getPropWrite<0>(key) = key.getKey() + j;
+			vd2.getPropWrite<0>(key) = key.getKey() + j;
+
+			++it2;
+		}
+
+		// at the third iteration vd move its particles, the labelling must be redone
+		if (j == 2)
+		{
+			auto it3 = vd.getDomainIterator();
+
+			while (it3.isNext())
+			{
+				auto key = it3.get();
+
+				vd.getPosWrite(key)[0] += 0.001f;
+				vd2.getPosWrite(key)[0] += 0.001f;
+
+				++it3;
+			}
+		}
+
+		// reading the positions does not invalidate the labelling
+		size_t ver = vd.getPosVersion();
+		float sum = 0.0;
+		for (size_t i = 0 ; i < vd.size_local() ; i++)
+		{sum += vd.getPos(i)[0];}
+		BOOST_REQUIRE_EQUAL(ver,vd.getPosVersion());
+		BOOST_REQUIRE(sum >= 0.0);
+
+		vd.ghost_get<0>(WITH_POSITION | GHOST_AUTO_REUSE);
+		vd2.ghost_get<0>(WITH_POSITION);
+
+		BOOST_REQUIRE_EQUAL(vd.size_local_with_ghost(),vd2.size_local_with_ghost());
+
+		bool match = true;
+		for (size_t i = vd.size_local() ; i < vd.size_local_with_ghost() ; i++)
+		{
+			match &= vd.getPosRead(i)[0] == vd2.getPosRead(i)[0];
+			match &= vd.getPosRead(i)[1] == vd2.getPosRead(i)[1];
+			match &= vd.getPosRead(i)[2] == vd2.getPosRead(i)[2];
+			match &= vd.getPropRead<0>(i) == vd2.getPropRead<0>(i);
+		}
+
+		BOOST_REQUIRE_EQUAL(match,true);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_periodic_test_clean_prop_ghost_get )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+
+	size_t k = 4096 * v_cl.getProcessingUnits();
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	// ghost
+	Ghost<3,float> ghost(0.05);
+
+	vector_dist<3,float, Point_test<float> > vd(k,box,bc,ghost);
+	vector_dist<3,float, Point_test<float> > vd2(vd.getDecomposition(),k);
+
+	auto it = vd.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		vd.getPosWrite(key)[0] = ud(eg);
+		vd.getPosWrite(key)[1] = ud(eg);
+		vd.getPosWrite(key)[2] = ud(eg);
+
+		vd2.getPosWrite(key)[0] = vd.getPosRead(key)[0];
+		vd2.getPosWrite(key)[1] = vd.getPosRead(key)[1];
+		vd2.getPosWrite(key)[2] = vd.getPosRead(key)[2];
+
+		++it;
+	}
+
+	vd.map();
+	vd2.map();
+
+	for (size_t j = 0 ; j < 6 ; j++)
+	{
+		auto it2 = vd.getDomainIterator();
+
+		while (it2.isNext())
+		{
+			auto key = it2.get();
+
+			// property 0 is written only at the first iteration, property 1 every two iterations
+			if (j == 0)
+			{
+				vd.getPropWrite<0>(key) = key.getKey();
+				vd2.getPropWrite<0>(key) = key.getKey();
+			}
+
+			if (j % 2 == 0)
+			{
+				vd.getPropWrite<1>(key) = key.getKey() + j;
+				vd2.getPropWrite<1>(key) = key.getKey() + j;
+			}
+
+			++it2;
+		}
+
+		// the ghost_get of vd sent only when something changed
+		vd.ghost_get<0,1>(WITH_POSITION | GHOST_AUTO_REUSE);
+
+		// the reference is always labelled again
+		vd2.ghost_get<0,1>();
+
+		BOOST_REQUIRE_EQUAL(vd.size_local_with_ghost(),vd2.size_local_with_ghost());
+
+		bool match = true;
+		for (size_t i = vd.size_local() ; i < vd.size_local_with_ghost() ; i++)
+		{
+			match &= vd.getPosRead(i)[0] == vd2.getPosRead(i)[0];
+			match &= vd.getPosRead(i)[1] == vd2.getPosRead(i)[1];
+			match &= vd.getPosRead(i)[2] == vd2.getPosRead(i)[2];
+			match &= vd.getPropRead<0>(i) == vd2.getPropRead<0>(i);
+			match &= vd.getPropRead<1>(i) == vd2.getPropRead<1>(i);
+		}
+
+		BOOST_REQUIRE_EQUAL(match,true);
+	}
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_periodic_test_reduced_precision_ghost_get )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<double> ud(0.0, 1.0);
+
+	size_t k = 4096 * v_cl.getProcessingUnits();
+
+	Box<3,double> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	// ghost
+	Ghost<3,double> ghost(0.05);
+
+	vector_dist<3,double, aggregate<double,double[3],size_t> > vd(k,box,bc,ghost);
+	vector_dist<3,double, aggregate<double,double[3],size_t> > vd2(vd.getDecomposition(),k);
+
+	auto it = vd.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		vd.getPosWrite(key)[0] = ud(eg);
+		vd.getPosWrite(key)[1] = ud(eg);
+		vd.getPosWrite(key)[2] = ud(eg);
+
+		vd2.getPosWrite(key)[0] = vd.getPosRead(key)[0];
+		vd2.getPosWrite(key)[1] = vd.getPosRead(key)[1];
+		vd2.getPosWrite(key)[2] = vd.getPosRead(key)[2];
+
+		++it;
+	}
+
+	vd.map();
+	vd2.map();
+
+	// the second iteration reuse the labelling
+	for (size_t j = 0 ; j < 2 ; j++)
+	{
+		auto it2 = vd.getDomainIterator();
+
+		while (it2.isNext())
+		{
+			auto key = it2.get();
+
+			vd.getPropWrite<0>(key) = 1.0 / (key.getKey() + j + 3);
+			vd2.getPropWrite<0>(key) = vd.getPropRead<0>(key);
+
+			for (size_t i = 0 ; i < 3 ; i++)
+			{
+				vd.getPropWrite<1>(key)[i] = vd.getPosRead(key)[i] + j;
+				vd2.getPropWrite<1>(key)[i] = vd.getPropRead<1>(key)[i];
+			}
+
+			vd.getPropWrite<2>(key) = key.getKey() + j;
+			vd2.getPropWrite<2>(key) = vd.getPropRead<2>(key);
+
+			++it2;
+		}
+
+		size_t opt = (j == 0)?0:SKIP_LABELLING;
+
+		vd.ghost_get<0,1,2>(opt | GHOST_REDUCED_PRECISION);
+		vd2.ghost_get<0,1,2>(opt);
+
+		BOOST_REQUIRE_EQUAL(vd.size_local_with_ghost(),vd2.size_local_with_ghost());
+
+		bool match = true;
+		for (size_t i = vd.size_local() ; i < vd.size_local_with_ghost() ; i++)
+		{
+			// positions are in full precision
+			match &= vd.getPosRead(i)[0] == vd2.getPosRead(i)[0];
+			match &= vd.getPosRead(i)[1] == vd2.getPosRead(i)[1];
+			match &= vd.getPosRead(i)[2] == vd2.getPosRead(i)[2];
+
+			// double properties within float precision
+			match &= fabs(vd.getPropRead<0>(i) - vd2.getPropRead<0>(i)) <= 1e-7 * fabs(vd2.getPropRead<0>(i));
+			match &= fabs(vd.getPropRead<1>(i)[0] - vd2.getPropRead<1>(i)[0]) <= 1e-7 * fabs(vd2.getPropRead<1>(i)[0]);
+			match &= fabs(vd.getPropRead<1>(i)[1] - vd2.getPropRead<1>(i)[1]) <= 1e-7 * fabs(vd2.getPropRead<1>(i)[1]);
+			match &= fabs(vd.getPropRead<1>(i)[2] - vd2.getPropRead<1>(i)[2]) <= 1e-7 * fabs(vd2.getPropRead<1>(i)[2]);
+
+			// other properties unchanged
+			match &= vd.getPropRead<2>(i) == vd2.getPropRead<2>(i);
+		}
+
+		BOOST_REQUIRE_EQUAL(match,true);
+	}
+}
+
+#ifdef _OPENMP
+
+BOOST_AUTO_TEST_CASE( vector_dist_periodic_test_labelling_omp )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+
+	size_t k = 16384 * v_cl.getProcessingUnits();
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	// factor
+	float factor = pow(create_vcluster().getProcessingUnits()/2.0f,1.0f/3.0f);
+
+	// ghost
+	Ghost<3,float> ghost(0.05 / factor);
+
+	vector_dist<3,float, Point_test<float> > vd(k,box,bc,ghost);
+	vector_dist<3,float, Point_test<float> > vd2(vd.getDecomposition(),k);
+
+	auto it = vd.getIterator();
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		vd.getPos(key)[0] = ud(eg);
+		vd.getPos(key)[1] = ud(eg);
+		vd.getPos(key)[2] = ud(eg);
+		vd.getProp<0>(key) = key.getKey();
+
+		vd2.getPos(key)[0] = vd.getPos(key)[0];
+		vd2.getPos(key)[1] = vd.getPos(key)[1];
+		vd2.getPos(key)[2] = vd.getPos(key)[2];
+		vd2.getProp<0>(key) = key.getKey();
+
+		++it;
+	}
+
+	int n_thr = omp_get_max_threads();
+
+	// serial labelling
+	omp_set_num_threads(1);
+	vd.map();
+	vd.ghost_get<0>();
+
+	// threaded labelling
+	omp_set_num_threads((n_thr > 1)?n_thr:4);
+	vd2.map();
+	vd2.ghost_get<0>();
+
+	omp_set_num_threads(n_thr);
+
+	// The result must be identical, including the order of the particles
+	BOOST_REQUIRE_EQUAL(vd.size_local(),vd2.size_local());
+	BOOST_REQUIRE_EQUAL(vd.size_local_with_ghost(),vd2.size_local_with_ghost());
+
+	bool match = true;
+	for (size_t i = 0 ; i < vd.size_local_with_ghost() ; i++)
+	{
+		match &= vd.getPos(i)[0] == vd2.getPos(i)[0];
+		match &= vd.getPos(i)[1] == vd2.getPos(i)[1];
+		match &= vd.getPos(i)[2] == vd2.getPos(i)[2];
+		match &= vd.getProp<0>(i) == vd2.getProp<0>(i);
+	}
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
+#endif
+
 BOOST_AUTO_TEST_CASE( vector_dist_periodic_map )
 {
 	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
@@ -1818,6 +2533,367 @@ BOOST_AUTO_TEST_CASE( vector_dist_ghost_put )
 	}
 }
 
+BOOST_AUTO_TEST_CASE( vector_dist_async_ghost_put )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	if (v_cl.getProcessingUnits() > 48)
+		return;
+
+	long int k = 24;
+
+	float r_cut = 1.3 / k;
+	float r_g = 1.5 / k;
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	// ghost
+	Ghost<3,float> ghost(r_g);
+
+	typedef  aggregate<float> part_prop;
+
+	// Distributed vector
+	vector_dist<3,float, part_prop > vd(0,box,bc,ghost);
+
+	auto it = vd.getGridIterator({(size_t)k,(size_t)k,(size_t)k});
+
+	while (it.isNext())
+	{
+		auto key = it.get();
+
+		vd.add();
+
+		vd.getLastPosWrite()[0] = key.get(0)*it.getSpacing(0);
+		vd.getLastPosWrite()[1] = key.get(1)*it.getSpacing(1);
+		vd.getLastPosWrite()[2] = key.get(2)*it.getSpacing(2);
+
+		vd.getLastPropWrite<0>() = 0.0;
+
+		++it;
+	}
+
+	vd.map();
+
+	float ref = 0.0;
+
+	// a ghost_get while the ghost_put is in flight must not change the result
+	for (size_t opt : {(size_t)NONE,(size_t)NO_CHANGE_ELEMENTS})
+	{
+		for (bool get_in_flight : {false,true})
+		{
+			auto itp = vd.getDomainIterator();
+			while (itp.isNext())
+			{
+				vd.getPropWrite<0>(itp.get()) = 0.0;
+				++itp;
+			}
+
+			vd.ghost_get<0>();
+
+			auto NN = vd.getCellList(r_cut);
+			float a = 1.0f*k*k;
+
+			auto it2 = vd.getDomainIterator();
+
+			while (it2.isNext())
+			{
+				auto p = it2.get();
+				Point<3,float> xp = vd.getPosRead(p);
+
+				auto Np = NN.getNNIterator<NO_CHECK>(NN.getCell(xp));
+
+				while (Np.isNext())
+				{
+					auto q = Np.get();
+					Point<3,float> xq = vd.getPosRead(q);
+
+					float dist = xp.distance(xq);
+
+					if (dist < r_cut)
+						vd.getPropWrite<0>(q) += a*(-dist*dist+r_cut*r_cut);
+
+					++Np;
+				}
+
+				++it2;
+			}
+
+			vd.Ighost_put<add_,0>(opt);
+
+			if (get_in_flight == true)
+			{vd.ghost_get<0>();}
+
+			vd.ghost_put_wait<add_,0>(opt);
+
+			// on a regular lattice all the particles must have the same value
+			bool ret = true;
+			auto it3 = vd.getDomainIterator();
+
+			float constant = vd.getPropRead<0>(it3.get());
+			float eps = 0.001;
+
+			while (it3.isNext())
+			{
+				float constant2 = vd.getPropRead<0>(it3.get());
+				if (fabs(constant - constant2)/constant > eps)
+				{
+					ret = false;
+					break;
+				}
+
+				++it3;
+			}
+			BOOST_REQUIRE_EQUAL(ret,true);
+
+			if (opt == NONE && get_in_flight == false)
+			{ref = constant;}
+			else
+			{BOOST_REQUIRE_CLOSE(constant,ref,0.01);}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_add_batch )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	// ghost
+	Ghost<3,float> ghost(0.05);
+
+	vector_dist<3,float, aggregate<float> > vd(0,box,bc,ghost);
+
+	for (size_t j = 0 ; j < 3 ; j++)
+	{
+		// inject new particles, the vector has ghost particles from the second iteration
+		auto it = vd.addBatch(1000);
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			// the new particles does not contain the old ghost
+			BOOST_REQUIRE_EQUAL(vd.getPropRead<0>(key),0.0f);
+			BOOST_REQUIRE_EQUAL(vd.getPosRead(key)[0],0.0f);
+
+			vd.getPosWrite(key)[0] = ud(eg);
+			vd.getPosWrite(key)[1] = ud(eg);
+			vd.getPosWrite(key)[2] = ud(eg);
+			vd.getPropWrite<0>(key) = 1.0;
+
+			++it;
+		}
+
+		vd.map();
+		vd.ghost_get<0>();
+
+		size_t cnt = vd.size_local();
+		float sum = 0.0;
+
+		auto it2 = vd.getDomainIterator();
+		while (it2.isNext())
+		{
+			sum += vd.getPropRead<0>(it2.get());
+			++it2;
+		}
+
+		v_cl.sum(cnt);
+		v_cl.sum(sum);
+		v_cl.execute();
+
+		BOOST_REQUIRE_EQUAL(cnt,1000*(j+1)*v_cl.getProcessingUnits());
+		BOOST_REQUIRE_EQUAL(sum,1000.0f*(j+1)*v_cl.getProcessingUnits());
+	}
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_remove_batch )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	// ghost
+	Ghost<3,float> ghost(0.05);
+
+	for (size_t opt = REMOVE_STABLE ; opt <= REMOVE_UNSTABLE ; opt++)
+	{
+		vector_dist<3,float, aggregate<size_t> > vd(0,box,bc,ghost);
+
+		// particles with id i at position i/n
+		size_t n = 20000;
+		auto it = vd.addBatch(n);
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			vd.getPosWrite(key)[0] = (float)key.getKey() / n;
+			vd.getPosWrite(key)[1] = 0.5;
+			vd.getPosWrite(key)[2] = 0.5;
+			vd.getPropWrite<0>(key) = key.getKey();
+
+			++it;
+		}
+
+		// remove the multiples of 3, with unsorted keys and duplicates
+		openfpm::vector<size_t> keys;
+		for (long int i = n-1 ; i >= 0 ; i--)
+		{
+			if (i % 3 == 0)
+			{keys.add(i);}
+		}
+		keys.add(0);
+
+		vd.removeKeys(keys,opt);
+
+		BOOST_REQUIRE_EQUAL(vd.size_local(),n - (n+2)/3);
+
+		bool match = true;
+		size_t last = 0;
+		std::vector<bool> found(n,false);
+
+		auto it2 = vd.getDomainIterator();
+		while (it2.isNext())
+		{
+			auto key = it2.get();
+			size_t id = vd.getPropRead<0>(key);
+
+			match &= id % 3 != 0;
+			match &= vd.getPosRead(key)[0] == (float)id / n;
+			match &= found[id] == false;
+			found[id] = true;
+
+			// the stable mode keep the order
+			if (opt == REMOVE_STABLE)
+			{match &= id > last;}
+			last = id;
+
+			++it2;
+		}
+
+		BOOST_REQUIRE_EQUAL(match,true);
+
+		// the vector work as before
+		vd.map();
+		vd.ghost_get<0>();
+
+		size_t cnt = vd.size_local();
+		v_cl.sum(cnt);
+		v_cl.execute();
+
+		BOOST_REQUIRE_EQUAL(cnt,(n - (n+2)/3)*v_cl.getProcessingUnits());
+	}
+}
+
+BOOST_AUTO_TEST_CASE( vector_dist_global_id_index )
+{
+	Vcluster<> & v_cl = create_vcluster();
+
+	std::default_random_engine eg(v_cl.getProcessUnitID());
+	std::uniform_real_distribution<float> ud(0.0f, 1.0f);
+
+	Box<3,float> box({0.0,0.0,0.0},{1.0,1.0,1.0});
+
+	// Boundary conditions
+	size_t bc[3]={PERIODIC,PERIODIC,PERIODIC};
+
+	// ghost
+	Ghost<3,float> ghost(0.05);
+
+	// global id, position of the particle when the id has been assigned
+	vector_dist<3,float, aggregate<size_t,float[3]> > vd(0,box,bc,ghost);
+
+	size_t n = 1000;
+
+	for (size_t j = 0 ; j < 2 ; j++)
+	{
+		size_t start = vd.size_local();
+		auto it = vd.addBatch(n);
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			for (size_t i = 0 ; i < 3 ; i++)
+			{
+				vd.getPosWrite(key)[i] = ud(eg);
+				vd.getPropWrite<1>(key)[i] = vd.getPosRead(key)[i];
+			}
+
+			++it;
+		}
+
+		vd.initGlobalIds<0>(start);
+
+		vd.map();
+		vd.reorder(4);
+		vd.ghost_get<0,1>();
+	}
+
+	size_t tot = n*2*v_cl.getProcessingUnits();
+
+	// every id in [0,tot) exist once
+	openfpm::vector<size_t> ids;
+	auto it2 = vd.getDomainIterator();
+	while (it2.isNext())
+	{
+		ids.add(vd.getPropRead<0>(it2.get()));
+		++it2;
+	}
+
+	openfpm::vector<size_t> ids_all;
+
+	v_cl.SGather(ids,ids_all,0);
+	v_cl.execute();
+
+	if (v_cl.getProcessUnitID() == 0)
+	{
+		BOOST_REQUIRE_EQUAL(ids_all.size(),tot);
+
+		ids_all.sort();
+		for (size_t i = 0 ; i < ids_all.size() ; i++)
+		{BOOST_REQUIRE_EQUAL(ids_all.get(i),i);}
+	}
+
+	// the index find the domain and ghost particles
+	auto & idx = vd.getGlobalIdIndex<0>();
+
+	bool match = true;
+	auto it3 = vd.getIterator();
+	while (it3.isNext())
+	{
+		auto key = it3.get();
+		size_t q = idx.find(vd.getPropRead<0>(key));
+
+		match &= q != gid_index::empty;
+		match &= vd.getPropRead<0>(q) == vd.getPropRead<0>(key);
+		match &= vd.getPropRead<1>(q)[0] == vd.getPropRead<1>(key)[0];
+
+		// domain particles find themselves
+		if (key.getKey() < vd.size_local())
+		{match &= q == key.getKey();}
+
+		++it3;
+	}
+
+	match &= idx.find(tot) == gid_index::empty;
+
+	BOOST_REQUIRE_EQUAL(match,true);
+}
+
 BOOST_AUTO_TEST_CASE( vector_fixing_noposition_and_keep_prop )
 {
 	Vcluster<> & v_cl = create_vcluster();
@@ -421,4 +421,63 @@ struct compare_host_device<base_type[N1][N2],prp>
 	}
 };
 
+/*! \brief Apply a permutation to the particle properties one property at a time
+ *
+ * For each property the permuted values are gathered in a scratch buffer that contain only that property, and
+ * copied back. The additional memory is the one of the biggest property instead of a full copy of the particles
+ *
+ * \tparam vector_type type of the vector of properties
+ * \tparam ids_type type of the vector with the permutation (element p take the particle ids.get(p))
+ *
+ */
+template<typename vector_type, typename ids_type>
+struct permute_prp_scratch
+{
+	//! vector of properties to permute
+	vector_type & v_prp;
+
+	//! permutation
+	ids_type & ids;
+
+	//! number of particles to permute
+	size_t n;
+
+	//! number of threads
+	long int n_thr;
+
+	/*! \brief constructor
+	 *
+	 * \param v_prp vector of properties to permute
+	 * \param ids permutation
+	 * \param n number of particles to permute
+	 * \param n_thr number of threads
+	 *
+	 */
+	permute_prp_scratch(vector_type & v_prp, ids_type & ids, size_t n, long int n_thr)
+	:v_prp(v_prp),ids(ids),n(n),n_thr(n_thr)
+	{}
+
+	//! It permute the property T
+	template<typename T>
+	inline void operator()(T& t)
+	{
+		typedef typename boost::mpl::at<typename vector_type::value_type::type,T>::type prp_type;
+
+		openfpm::vector<aggregate<prp_type>> scratch;
+		scratch.resize(n);
+
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+		for (long int p = 0 ; p < (long int)n ; p++)
+		{meta_copy<prp_type>::meta_copy_(v_prp.template get<T::value>(ids.get(p)),scratch.template get<0>(p));}
+
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+		for (long int p = 0 ; p < (long int)n ; p++)
+		{meta_copy<prp_type>::meta_copy_(scratch.template get<0>(p),v_prp.template get<T::value>(p));}
+	}
+};
+
 #endif /* VECTOR_DIST_FUNCS_HPP_ */
@@ -0,0 +1,156 @@
+/*
+ * vector_dist_gid_index.hpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef VECTOR_DIST_GID_INDEX_HPP_
+#define VECTOR_DIST_GID_INDEX_HPP_
+
+#include "Vector/util/vector_dist_reorder.hpp"
+
+/*! \brief Open addressing hash map from particle global id to local index
+ *
+ * It use linear probing on a power of two table with load factor at most 0.5
+ *
+ */
+struct gid_index
+{
+	//! value of the empty slots
+	static const size_t empty = (size_t)-1;
+
+	//! global id in the slot
+	openfpm::vector<size_t> key;
+
+	//! local index in the slot
+	openfpm::vector<size_t> val;
+
+	//! size of the table minus one
+	size_t mask = 0;
+
+	/*! \brief Mix the bits of the global id (finalizer of MurmurHash3)
+	 *
+	 * \param id global id
+	 *
+	 * \return the hash
+	 *
+	 */
+	static inline size_t hash(size_t id)
+	{
+		id ^= id >> 33;
+		id *= 0xff51afd7ed558ccdULL;
+		id ^= id >> 33;
+		id *= 0xc4ceb9fe1a85ec53ULL;
+		id ^= id >> 33;
+
+		return id;
+	}
+
+	/*! \brief Remove all the elements and prepare the table for n elements
+	 *
+	 * \param n number of elements
+	 *
+	 */
+	void reset(size_t n)
+	{
+		size_t sz = 16;
+		while (sz < 2*n)
+		{sz <<= 1;}
+
+		key.resize(sz);
+		val.resize(sz);
+		mask = sz - 1;
+
+		long int n_thr = sfc_n_threads(sz);
+
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+		for (long int i = 0 ; i < (long int)sz ; i++)
+		{key.get(i) = empty;}
+	}
+
+	/*! \brief Insert an element, if id is already present the old local index is kept
+	 *
+	 * \param id global id
+	 * \param idx local index
+	 *
+	 * \return true if the element has been inserted
+	 *
+	 */
+	inline bool insert(size_t id, size_t idx)
+	{
+		size_t s = hash(id) & mask;
+
+		while (key.get(s) != empty)
+		{
+			if (key.get(s) == id)
+			{return false;}
+
+			s = (s + 1) & mask;
+		}
+
+		key.get(s) = id;
+		val.get(s) = idx;
+
+		return true;
+	}
+
+	/*! \brief Insert an element concurrently with other insert_atomic, if id is already present the old local index is kept
+	 *
+	 * The slot is claimed with a compare and swap on the key, so no find must run concurrently
+	 *
+	 * \param id global id
+	 * \param idx local index
+	 *
+	 * \return true if the element has been inserted
+	 *
+	 */
+	inline bool insert_atomic(size_t id, size_t idx)
+	{
+		size_t s = hash(id) & mask;
+
+		while (true)
+		{
+			size_t k = empty;
+			if (__atomic_compare_exchange_n(&key.get(s),&k,id,false,__ATOMIC_RELAXED,__ATOMIC_RELAXED) == true)
+			{
+				val.get(s) = idx;
+				return true;
+			}
+
+			// k contain the key that occupy the slot
+			if (k == id)
+			{return false;}
+
+			s = (s + 1) & mask;
+		}
+	}
+
+	/*! \brief Get the local index of a global id
+	 *
+	 * \param id global id
+	 *
+	 * \return the local index, gid_index::empty if the particle is not present
+	 *
+	 */
+	inline size_t find(size_t id) const
+	{
+		if (key.size() == 0)
+		{return empty;}
+
+		size_t s = hash(id) & mask;
+
+		while (key.get(s) != empty)
+		{
+			if (key.get(s) == id)
+			{return val.get(s);}
+
+			s = (s + 1) & mask;
+		}
+
+		return empty;
+	}
+};
+
+#endif /* VECTOR_DIST_GID_INDEX_HPP_ */
@@ -0,0 +1,168 @@
+/*
+ * vector_dist_pair_packet.hpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef VECTOR_DIST_PAIR_PACKET_HPP_
+#define VECTOR_DIST_PAIR_PACKET_HPP_
+
+//! Width in bytes of the widest SIMD register the code is compiled for
+#if defined(__AVX512F__)
+constexpr size_t pair_packet_simd_bytes = 64;
+#elif defined(__AVX__)
+constexpr size_t pair_packet_simd_bytes = 32;
+#else
+constexpr size_t pair_packet_simd_bytes = 16;
+#endif
+
+/*! \brief Packet of particle pairs (p,q) that share the same p
+ *
+ * The components are stored as structure of arrays of SIMD width, so a loop over the lanes
+ * is vectorized by the compiler. Lanes after n are padding, they have mask equal to zero, dx equal to zero
+ * and r2 equal to one (so that a kernel can divide by r2 without a check)
+ *
+ * \tparam dim dimensionality
+ * \tparam St type of space
+ *
+ */
+template<unsigned int dim, typename St>
+struct pair_packet
+{
+	//! number of lanes
+	static const size_t width = (pair_packet_simd_bytes / sizeof(St) < 4)?4:pair_packet_simd_bytes / sizeof(St);
+
+	//! number of valid lanes
+	size_t n;
+
+	//! neighborhood particle q of each lane
+	size_t q[width];
+
+	//! xp - xq
+	alignas(pair_packet_simd_bytes) St dx[dim][width];
+
+	//! squared distance between p and q
+	alignas(pair_packet_simd_bytes) St r2[width];
+
+	//! one for the valid lanes, zero for the padding
+	alignas(pair_packet_simd_bytes) St mask[width];
+
+	//! Constructor
+	pair_packet()
+	:n(0)
+	{
+		pad();
+	}
+
+	/*! \brief Add a candidate neighborhood particle with its position
+	 *
+	 * The position is stored in dx, distance() turn it into xp - xq for all the lanes at once
+	 *
+	 * \param q_ neighborhood particle
+	 * \param xq position of q_
+	 *
+	 */
+	inline void add_pos(size_t q_, const Point<dim,St> & xq)
+	{
+		q[n] = q_;
+		for (size_t i = 0 ; i < dim ; i++)
+		{dx[i][n] = xq.get(i);}
+		n++;
+	}
+
+	/*! \brief Compute dx, r2 and mask of the candidates added with add_pos
+	 *
+	 * The lanes are processed all together (structure of arrays), a lane is valid if it is a candidate
+	 * different from p and closer than the cut-off radius
+	 *
+	 * \param xp position of p
+	 * \param r_cut2 squared cut-off radius
+	 * \param p particle p
+	 *
+	 */
+	inline void distance(const Point<dim,St> & xp, St r_cut2, size_t p)
+	{
+		for (size_t l = 0 ; l < width ; l++)
+		{r2[l] = 0;}
+
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			St xpi = xp.get(i);
+
+#ifdef _OPENMP
+			#pragma omp simd
+#endif
+			for (size_t l = 0 ; l < width ; l++)
+			{
+				dx[i][l] = xpi - dx[i][l];
+				r2[l] += dx[i][l]*dx[i][l];
+			}
+		}
+
+#ifdef _OPENMP
+		#pragma omp simd
+#endif
+		for (size_t l = 0 ; l < width ; l++)
+		{mask[l] = (l < n && q[l] != p && r2[l] < r_cut2)?1:0;}
+	}
+
+	/*! \brief Add the lane l of another packet
+	 *
+	 * \param pk packet
+	 * \param l lane
+	 *
+	 */
+	inline void add_lane(const pair_packet<dim,St> & pk, size_t l)
+	{
+		q[n] = pk.q[l];
+		for (size_t i = 0 ; i < dim ; i++)
+		{dx[i][n] = pk.dx[i][l];}
+		r2[n] = pk.r2[l];
+		mask[n] = 1;
+		n++;
+	}
+
+	/*! \brief Add a pair to the packet
+	 *
+	 * \param q_ neighborhood particle
+	 * \param dx_ xp - xq
+	 * \param r2_ squared distance
+	 *
+	 */
+	inline void add(size_t q_, const Point<dim,St> & dx_, St r2_)
+	{
+		q[n] = q_;
+		for (size_t i = 0 ; i < dim ; i++)
+		{dx[i][n] = dx_.get(i);}
+		r2[n] = r2_;
+		mask[n] = 1;
+		n++;
+	}
+
+	/*! \brief Indicate if the packet is full
+	 *
+	 * \return true if all the lanes are valid
+	 *
+	 */
+	inline bool full() const
+	{
+		return n == width;
+	}
+
+	/*! \brief Fill the lanes after n with the padding
+	 *
+	 */
+	inline void pad()
+	{
+		for (size_t l = n ; l < width ; l++)
+		{
+			q[l] = 0;
+			for (size_t i = 0 ; i < dim ; i++)
+			{dx[i][l] = 0;}
+			r2[l] = 1;
+			mask[l] = 0;
+		}
+	}
+};
+
+#endif /* VECTOR_DIST_PAIR_PACKET_HPP_ */
@@ -0,0 +1,245 @@
+/*
+ * vector_dist_reorder.hpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef VECTOR_DIST_REORDER_HPP_
+#define VECTOR_DIST_REORDER_HPP_
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+//! Minimum number of particles to reorder with more threads
+constexpr size_t sfc_omp_min = 16384;
+
+/*! \brief Buffers used to sort the particles along a space filling curve
+ *
+ * They are retained by vector_dist, so a reorder does not allocate after the first one
+ *
+ */
+struct sfc_sort_buffers
+{
+	//! key of each particle on the curve
+	openfpm::vector<size_t> key;
+
+	//! particle id, after the sort it is the permutation to apply
+	openfpm::vector<size_t> id;
+
+	//! scratch for the keys
+	openfpm::vector<size_t> key_tmp;
+
+	//! scratch for the ids
+	openfpm::vector<size_t> id_tmp;
+
+	//! per thread histogram
+	openfpm::vector<size_t> cnt;
+};
+
+/*! \brief Number of threads to use to reorder n particles
+ *
+ * \param n number of particles
+ *
+ * \return the number of threads
+ *
+ */
+inline size_t sfc_n_threads(size_t n)
+{
+#ifdef _OPENMP
+	if (n >= sfc_omp_min)
+	{return omp_get_max_threads();}
+#endif
+
+	return 1;
+}
+
+/*! \brief Index of the cell x on the Hilbert curve of order m
+ *
+ * It use the transpose algorithm of J. Skilling, "Programming the Hilbert curve"
+ *
+ * \tparam dim dimensionality
+ *
+ * \param x cell coordinates (each one smaller than 2^m), it is overwritten
+ * \param m order of the curve (dim*m <= 64)
+ *
+ * \return the index on the curve
+ *
+ */
+template<unsigned int dim> inline size_t sfc_hilbert_key(size_t (& x)[dim], unsigned int m)
+{
+	if (m == 0)
+	{return 0;}
+
+	size_t M = (size_t)1 << (m-1);
+
+	// Inverse undo
+	for (size_t Q = M ; Q > 1 ; Q >>= 1)
+	{
+		size_t P = Q - 1;
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			if (x[i] & Q)
+			{x[0] ^= P;}
+			else
+			{
+				size_t t = (x[0] ^ x[i]) & P;
+				x[0] ^= t;
+				x[i] ^= t;
+			}
+		}
+	}
+
+	// Gray encode
+	for (size_t i = 1 ; i < dim ; i++)
+	{x[i] ^= x[i-1];}
+
+	size_t t = 0;
+	for (size_t Q = M ; Q > 1 ; Q >>= 1)
+	{
+		if (x[dim-1] & Q)
+		{t ^= Q - 1;}
+	}
+
+	for (size_t i = 0 ; i < dim ; i++)
+	{x[i] ^= t;}
+
+	// interleave the transposed index
+	size_t key = 0;
+	for (long int b = m-1 ; b >= 0 ; b--)
+	{
+		for (size_t i = 0 ; i < dim ; i++)
+		{key = (key << 1) | ((x[i] >> b) & 1);}
+	}
+
+	return key;
+}
+
+/*! \brief Linear index of the cell x on a grid of 2^m cells per dimension, the first dimension is the fastest
+ *
+ * \tparam dim dimensionality
+ *
+ * \param x cell coordinates (each one smaller than 2^m)
+ * \param m order of the curve (dim*m <= 64)
+ *
+ * \return the linear index
+ *
+ */
+template<unsigned int dim> inline size_t sfc_linear_key(size_t (& x)[dim], unsigned int m)
+{
+	size_t key = 0;
+	for (long int i = dim-1 ; i >= 0 ; i--)
+	{key = (key << m) | x[i];}
+
+	return key;
+}
+
+/*! \brief Index of the cell x on the Morton (Z-order) curve of order m, the first dimension is the fastest
+ *
+ * \tparam dim dimensionality
+ *
+ * \param x cell coordinates (each one smaller than 2^m)
+ * \param m order of the curve (dim*m <= 64)
+ *
+ * \return the index on the curve
+ *
+ */
+template<unsigned int dim> inline size_t sfc_morton_key(size_t (& x)[dim], unsigned int m)
+{
+	size_t key = 0;
+	for (long int b = m-1 ; b >= 0 ; b--)
+	{
+		for (long int i = dim-1 ; i >= 0 ; i--)
+		{key = (key << 1) | ((x[i] >> b) & 1);}
+	}
+
+	return key;
+}
+
+/*! \brief Stable sort of the ids by key with a multi-threaded LSD radix sort
+ *
+ * Every thread build the histogram of a contiguous chunk, the chunks are scattered in thread order,
+ * so the sort is stable. The passes where all the keys have the same digit are skipped
+ *
+ * \param buf buffers, key and id are the input and the output
+ * \param n_bits number of significant bits of the keys
+ *
+ */
+inline void sfc_radix_sort(sfc_sort_buffers & buf, size_t n_bits)
+{
+	const size_t radix_bits = 8;
+	const size_t radix = 1 << radix_bits;
+
+	size_t n = buf.key.size();
+	long int n_thr = sfc_n_threads(n);
+
+	buf.key_tmp.resize(n);
+	buf.id_tmp.resize(n);
+	buf.cnt.resize(n_thr*radix);
+
+	for (size_t shift = 0 ; shift < n_bits ; shift += radix_bits)
+	{
+#ifdef _OPENMP
+		#pragma omp parallel for schedule(static,1) num_threads(n_thr) if (n_thr > 1)
+#endif
+		for (long int t = 0 ; t < n_thr ; t++)
+		{
+			size_t * cnt = &buf.cnt.get(t*radix);
+			for (size_t d = 0 ; d < radix ; d++)
+			{cnt[d] = 0;}
+
+			size_t start = n*t / n_thr;
+			size_t stop = n*(t+1) / n_thr;
+
+			for (size_t i = start ; i < stop ; i++)
+			{cnt[(buf.key.get(i) >> shift) & (radix - 1)]++;}
+		}
+
+		// offsets, digit major and thread minor to keep the sort stable
+		bool skip = false;
+		size_t offset = 0;
+		for (size_t d = 0 ; d < radix ; d++)
+		{
+			size_t start = offset;
+			for (long int t = 0 ; t < n_thr ; t++)
+			{
+				size_t c = buf.cnt.get(t*radix + d);
+				buf.cnt.get(t*radix + d) = offset;
+				offset += c;
+			}
+
+			if (offset - start == n)
+			{skip = true;}
+		}
+
+		// all the particles have the same digit
+		if (skip == true)
+		{continue;}
+
+#ifdef _OPENMP
+		#pragma omp parallel for schedule(static,1) num_threads(n_thr) if (n_thr > 1)
+#endif
+		for (long int t = 0 ; t < n_thr ; t++)
+		{
+			size_t * cnt = &buf.cnt.get(t*radix);
+
+			size_t start = n*t / n_thr;
+			size_t stop = n*(t+1) / n_thr;
+
+			for (size_t i = start ; i < stop ; i++)
+			{
+				size_t k = buf.key.get(i);
+				size_t & pos = cnt[(k >> shift) & (radix - 1)];
+
+				buf.key_tmp.get(pos) = k;
+				buf.id_tmp.get(pos) = buf.id.get(i);
+				pos++;
+			}
+		}
+
+		buf.key.swap(buf.key_tmp);
+		buf.id.swap(buf.id_tmp);
+	}
+}
+
+#endif /* VECTOR_DIST_REORDER_HPP_ */
@@ -0,0 +1,289 @@
+/*
+ * vector_dist_thread_acc.hpp
+ *
+ *  Created on: Oct 16, 2026
+ */
+
+#ifndef VECTOR_DIST_THREAD_ACC_HPP_
+#define VECTOR_DIST_THREAD_ACC_HPP_
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*! \brief Access the component i of a scalar property
+ *
+ * \tparam T type of the property
+ *
+ */
+template<typename T>
+struct thread_acc_comp
+{
+	//! number of components
+	static const size_t n_comp = 1;
+
+	/*! \brief Get the component
+	 *
+	 * \param r property
+	 * \param i component (ignored)
+	 *
+	 * \return the component
+	 *
+	 */
+	template<typename R> static inline R && get(R && r, size_t i)
+	{
+		return std::forward<R>(r);
+	}
+};
+
+/*! \brief Access the component i of a one dimensional array property
+ *
+ * \tparam T type of the array element
+ * \tparam N size of the array
+ *
+ */
+template<typename T, size_t N>
+struct thread_acc_comp<T[N]>
+{
+	//! number of components
+	static const size_t n_comp = N;
+
+	/*! \brief Get the component
+	 *
+	 * \param r property
+	 * \param i component
+	 *
+	 * \return the component
+	 *
+	 */
+	template<typename R> static inline auto get(R && r, size_t i) -> decltype(r[i])
+	{
+		return r[i];
+	}
+};
+
+//! the thread accumulators are reduced in blocks of 2^THREAD_ACC_BLK_SHIFT particles
+#define THREAD_ACC_BLK_SHIFT 10
+
+/*! \brief Accumulation buffer of one thread
+ *
+ * For each particle (domain and ghost) it store n_comp values. It mark the blocks of particles
+ * accessed, so that only these blocks are reduced
+ *
+ * \tparam T type of the component
+ * \tparam n_comp number of components
+ *
+ */
+template<typename T, size_t n_comp>
+struct thread_acc_view
+{
+	//! buffer of the thread
+	T * ptr;
+
+	//! one marker for each block of particles of the thread
+	unsigned char * blk;
+
+	/*! \brief Get the accumulator of the particle key
+	 *
+	 * \param key particle
+	 *
+	 * \return a pointer to the n_comp accumulated values
+	 *
+	 */
+	inline T * get(size_t key)
+	{
+		blk[key >> THREAD_ACC_BLK_SHIFT] = 1;
+
+		return ptr + key*n_comp;
+	}
+};
+
+/*! \brief Memory of the thread private accumulation buffers
+ *
+ * It is kept between two accumulations, so it is allocated only when the number of particles grow. Outside
+ * an accumulation the buffers and the block markers are always zero (the reduction set to zero what it read),
+ * so they do not need to be cleaned
+ *
+ */
+struct thread_acc_mem
+{
+	//! one buffer for each thread
+	openfpm::vector<openfpm::vector<unsigned char>> buf;
+
+	//! block markers for each thread
+	openfpm::vector<openfpm::vector<unsigned char>> blk;
+
+	/*! \brief Be sure that every thread has a buffer of at least sz bytes and n_blk block markers
+	 *
+	 * \param n_thr number of threads
+	 * \param sz size in byte
+	 * \param n_blk number of blocks
+	 *
+	 */
+	void prepare(size_t n_thr, size_t sz, size_t n_blk)
+	{
+		if (buf.size() < n_thr)
+		{
+			buf.resize(n_thr);
+			blk.resize(n_thr);
+		}
+
+		bool grow = false;
+		for (size_t t = 0 ; t < n_thr ; t++)
+		{grow |= buf.get(t).size() < sz || blk.get(t).size() < n_blk;}
+
+		if (grow == false)
+		{return;}
+
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+		for (long int t = 0 ; t < (long int)n_thr ; t++)
+		{
+			// the thread touch first its own buffer
+			size_t old = buf.get(t).size();
+
+			if (old < sz)
+			{
+				buf.get(t).resize(sz);
+				unsigned char * ptr = &buf.get(t).get(0);
+
+				for (size_t i = old ; i < sz ; i++)
+				{ptr[i] = 0;}
+			}
+
+			old = blk.get(t).size();
+
+			if (old < n_blk)
+			{
+				blk.get(t).resize(n_blk);
+
+				for (size_t i = old ; i < n_blk ; i++)
+				{blk.get(t).get(i) = 0;}
+			}
+		}
+	}
+};
+
+/*! \brief Thread private accumulation buffers for a particle property
+ *
+ * Every thread add its contributions in its own buffer, at the end the buffers are summed in the property.
+ * In this way both the particles of a symmetric interaction can be updated without atomics. Only the blocks of
+ * particles accessed by each thread are reduced (and set back to zero), so a thread that access its own domain
+ * particles and few ghost particles far in memory does not cause the reduction of all the particles in between
+ *
+ * \tparam T type of the property (scalar or one dimensional array)
+ *
+ */
+template<typename T>
+struct vector_dist_thread_acc
+{
+	static_assert(std::rank<T>::value <= 1,"vector_dist_thread_acc support only scalar and one dimensional array properties");
+
+	//! type of the component
+	typedef typename std::remove_all_extents<T>::type base_type;
+
+	//! number of components
+	static const size_t n_comp = thread_acc_comp<T>::n_comp;
+
+	//! memory of the buffers
+	thread_acc_mem & mem;
+
+	//! number of threads
+	size_t n_thr = 0;
+
+	//! number of particles
+	size_t n = 0;
+
+	//! number of blocks of particles
+	size_t n_blk = 0;
+
+	//! number of particles reduced by the last reduce, summed over the threads
+	size_t n_reduced = 0;
+
+	/*! \brief Constructor
+	 *
+	 * \param mem memory of the buffers
+	 *
+	 */
+	vector_dist_thread_acc(thread_acc_mem & mem)
+	:mem(mem)
+	{}
+
+	/*! \brief Prepare the buffers
+	 *
+	 * \param n_thr number of threads
+	 * \param n_part number of particles
+	 *
+	 */
+	void init(size_t n_thr, size_t n_part)
+	{
+		this->n_thr = n_thr;
+		n = n_part;
+		n_blk = (n + ((size_t)1 << THREAD_ACC_BLK_SHIFT) - 1) >> THREAD_ACC_BLK_SHIFT;
+		mem.prepare(n_thr,n*n_comp*sizeof(base_type),n_blk);
+	}
+
+	/*! \brief Get the buffer of the thread t
+	 *
+	 * \param t thread
+	 *
+	 * \return the buffer of the thread
+	 *
+	 */
+	thread_acc_view<base_type,n_comp> getView(size_t t)
+	{
+		if (n == 0)
+		{return thread_acc_view<base_type,n_comp>{NULL,NULL};}
+
+		return thread_acc_view<base_type,n_comp>{(base_type *)&mem.buf.get(t).get(0),&mem.blk.get(t).get(0)};
+	}
+
+	/*! \brief Add the buffers of all the threads to the property prp
+	 *
+	 * \tparam prp property
+	 *
+	 * \param v_prp properties of the particles
+	 *
+	 */
+	template<unsigned int prp, typename vector_prp_type> void reduce(vector_prp_type & v_prp)
+	{
+		size_t n_red = 0;
+
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(n_thr) reduction(+:n_red) schedule(dynamic,16) if (n_thr > 1)
+#endif
+		for (long int b = 0 ; b < (long int)n_blk ; b++)
+		{
+			size_t start = b << THREAD_ACC_BLK_SHIFT;
+			size_t stop = std::min(n,start + ((size_t)1 << THREAD_ACC_BLK_SHIFT));
+
+			for (size_t t = 0 ; t < n_thr ; t++)
+			{
+				unsigned char & mark = mem.blk.get(t).get(b);
+
+				if (mark == 0)
+				{continue;}
+
+				mark = 0;
+				n_red += stop - start;
+
+				base_type * bt = (base_type *)&mem.buf.get(t).get(0);
+
+				for (size_t p = start ; p < stop ; p++)
+				{
+					for (size_t i = 0 ; i < n_comp ; i++)
+					{
+						base_type & v = bt[p*n_comp + i];
+						thread_acc_comp<T>::get(v_prp.template get<prp>(p),i) += v;
+						v = 0;
+					}
+				}
+			}
+		}
+
+		n_reduced = n_red;
+	}
+};
+
+#endif /* VECTOR_DIST_THREAD_ACC_HPP_ */
@@ -32,6 +32,10 @@
 #include "data_type/aggregate.hpp"
 #include "NN/VerletList/VerletList.hpp"
 #include "vector_dist_comm.hpp"
+#include "Vector/util/vector_dist_reorder.hpp"
+#include "Vector/util/vector_dist_thread_acc.hpp"
+#include "Vector/util/vector_dist_pair_packet.hpp"
+#include "Vector/util/vector_dist_gid_index.hpp"
 #include "DLB/LB_Model.hpp"
 #include "Vector/vector_map_iterator.hpp"
 #include "NN/CellList/ParticleIt_Cells.hpp"
@@ -193,7 +197,17 @@ enum reorder_opt
 {
 	NO_REORDER = 0,
 	HILBERT = 1,
-	LINEAR = 2
+	LINEAR = 2,
+	MORTON = 3
+};
+
+//! How the particles are compacted by removeMarked and removeKeys
+enum remove_opt
+{
+	//! the remaining particles keep their order
+	REMOVE_STABLE = 0,
+	//! the holes are filled with the particles at the end of the vector
+	REMOVE_UNSTABLE = 1
 };
 
 template<typename vector, unsigned int impl>
@@ -292,6 +306,124 @@ private:
 	//! reordered v_prp buffer
 	openfpm::vector<Point<dim, St>,Memory,layout_base> v_pos_out;
 
+	//! buffers for the space filling curve reorder
+	sfc_sort_buffers sfc_buf;
+
+	//! mask of the particles to remove used by removeKeys
+	openfpm::vector<unsigned char> rm_mask;
+
+	//! next global id to assign (equal on all processors)
+	size_t gid_next = 0;
+
+	//! index from global id to local index
+	gid_index gid_idx;
+
+	//! indicate that gid_idx has been built
+	bool gid_built = false;
+
+	//! ghost marker when gid_idx has been built
+	size_t gid_g_m = 0;
+
+	//! number of particles indexed by gid_idx
+	size_t gid_size = 0;
+
+	//! version of the particle indexes when gid_idx has been built
+	size_t gid_idx_version = 0;
+
+	//! ghost labelling epoch when gid_idx has been built
+	size_t gid_gg_epoch = 0;
+
+	//! curve used by the auto-reorder (NO_REORDER disable it)
+	reorder_opt ar_opt = reorder_opt::NO_REORDER;
+
+	//! order of the curve used by the auto-reorder
+	int32_t ar_m = 0;
+
+	//! the auto-reorder trigger when the locality metric is bigger than ar_threshold times the one after the last reorder
+	double ar_threshold = 2.0;
+
+	//! the time from the last reorder must be at least ar_amort times the cost of the reorder
+	double ar_amort = 10.0;
+
+	//! locality metric after the last reorder (negative if no reorder has been done)
+	double ar_base = -1.0;
+
+	//! time spent by the last reorder
+	double ar_t_reorder = 0.0;
+
+	//! time from the last reorder
+	double ar_elapsed = 0.0;
+
+	//! timer for the auto-reorder
+	timer ar_time;
+
+	//! State of the incremental update of one cell-list (see updateCellListIncremental)
+	struct icl_state
+	{
+		//! cell-list, identified by its address
+		const void * ptr;
+
+		//! number of cells in each direction of the cell-list
+		size_t div[dim];
+
+		//! version of the particle indexes at the last update
+		size_t idx_version;
+
+		//! ghost marker at the last update
+		size_t g_m;
+
+		//! cell of each particle (domain and ghost) at the last update
+		openfpm::vector<size_t> cell;
+
+		//! position of each particle inside its cell at the last update
+		openfpm::vector<size_t> slot;
+	};
+
+	//! maximum number of cell-lists tracked by the incremental update
+	static const size_t icl_max = 8;
+
+	//! state of the cell-lists updated incrementally
+	openfpm::vector<icl_state> icl_st;
+
+	//! next state to replace when more than icl_max cell-lists are tracked
+	size_t icl_next = 0;
+
+	//! cells that contained ghost particles at the last incremental cell-list update
+	openfpm::vector<size_t> icl_gcell;
+
+	//! cell of the actual ghost particles
+	openfpm::vector<size_t> icl_gnew;
+
+	//! marker for the cells in icl_gcell
+	openfpm::vector<unsigned char> icl_mark;
+
+	//! thread private buffers of parallel_for_CRS, kept between the calls
+	thread_acc_mem crs_acc_mem;
+
+	//! Verlet list managed by the vector (see getManagedVerlet)
+	VerletList<dim,St,Mem_fast<>,shift<dim,St>,decltype(v_pos)> ver_m;
+
+	//! position of the domain particles when ver_m has been built
+	openfpm::vector<Point<dim,St>> ver_x0;
+
+	//! cut-off radius of the managed Verlet list
+	St ver_r_cut = 0;
+
+	//! skin of the managed Verlet list
+	St ver_skin = 0;
+
+	//! indicate that ver_m has been built
+	bool ver_built = false;
+
+	//! version of the particle indexes when ver_m has been built
+	size_t ver_idx_version = 0;
+
+	//! ghost labelling epoch when ver_m has been built
+	size_t ver_gg_epoch = 0;
+
+	//! ghost marker when ver_m has been built
+	size_t ver_g_m = 0;
+
 	//! option used to create this vector
 	size_t opt = 0;
 
@@ -365,6 +497,20 @@ private:
 		}
 	}
 
+	/*! \brief It check that no Ighost_put is waiting for ghost_put_wait
+	 *
+	 * \param fn name of the calling function
+	 *
+	 */
+	void check_no_ghost_put_in_flight(const char * fn)
+	{
+		if (this->isGhostPutInFlight() == true)
+		{
+			std::cerr << __FILE__ << ":" << __LINE__ << " Error " << fn << " called while an Ighost_put is in flight, call ghost_put_wait first" << std::endl;
+			ACTION_ON_ERROR(VECTOR_DIST_ERROR_OBJECT);
+		}
+	}
+
 	/*! \brief Reorder based on hilbert space filling curve
 	 *
 	 * \param v_pos_dest reordered vector of position
@@ -411,6 +557,88 @@ private:
 		}
 	}
 
+	/*! \brief Calculate for each local particle its key on a space filling curve
+	 *
+	 * The box is divided in 2^m cells per dimension, particles outside the box are assigned to the
+	 * nearest cell
+	 *
+	 * \param bx box covered by the curve
+	 * \param m order of the curve
+	 * \param opt type of curve
+	 *
+	 */
+	void reorder_keys(const Box<dim,St> & bx, unsigned int m, reorder_opt opt)
+	{
+		sfc_buf.key.resize(g_m);
+		sfc_buf.id.resize(g_m);
+
+		long int n_cell = (long int)1 << m;
+
+		St inv_sz[dim];
+		for (size_t i = 0 ; i < dim ; i++)
+		{inv_sz[i] = n_cell / (bx.getHigh(i) - bx.getLow(i));}
+
+		long int n_thr = sfc_n_threads(g_m);
+
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+		for (long int p = 0 ; p < (long int)g_m ; p++)
+		{
+			size_t x[dim];
+
+			for (size_t i = 0 ; i < dim ; i++)
+			{
+				long int c = (long int)((v_pos.template get<0>(p)[i] - bx.getLow(i)) * inv_sz[i]);
+				c = (c < 0)?0:c;
+				c = (c >= n_cell)?n_cell-1:c;
+
+				x[i] = c;
+			}
+
+			if (opt == reorder_opt::HILBERT)
+			{sfc_buf.key.get(p) = sfc_hilbert_key<dim>(x,m);}
+			else if (opt == reorder_opt::MORTON)
+			{sfc_buf.key.get(p) = sfc_morton_key<dim>(x,m);}
+			else
+			{sfc_buf.key.get(p) = sfc_linear_key<dim>(x,m);}
+
+			sfc_buf.id.get(p) = p;
+		}
+	}
+
+	/*! \brief Apply the permutation in sfc_buf.id to the local particles
+	 *
+	 * Positions and properties are permuted one property at a time, through a scratch buffer that contain
+	 * only that property, so the local particles are never copied entirely. Only the first g_m particles are
+	 * touched
+	 *
+	 */
+	void reorder_permute()
+	{
+		long int n_thr = sfc_n_threads(g_m);
+
+		{
+			openfpm::vector<Point<dim,St>> scratch;
+			scratch.resize(g_m);
+
+#ifdef _OPENMP
+			#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+			for (long int p = 0 ; p < (long int)g_m ; p++)
+			{scratch.get(p) = v_pos.get(sfc_buf.id.get(p));}
+
+#ifdef _OPENMP
+			#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+			for (long int p = 0 ; p < (long int)g_m ; p++)
+			{v_pos.get(p) = scratch.get(p);}
+		}
+
+		permute_prp_scratch<decltype(v_prp),decltype(sfc_buf.id)> pps(v_prp,sfc_buf.id,g_m,n_thr);
+		boost::mpl::for_each_ref<boost::mpl::range_c<int,0,prop::max_prop>>(pps);
+	}
+
 public:
 
 	//! property object
@@ -453,6 +681,10 @@ public:
 
 		opt = v.opt;
 
+		this->lazy_map_invalidate();
+		this->incIdxVersion();
+		this->incPosVersion();
+
 		return *this;
 	}
 
@@ -478,6 +710,10 @@ public:
 
 		opt = v.opt;
 
+		this->lazy_map_invalidate();
+		this->incIdxVersion();
+		this->incPosVersion();
+
 		return *this;
 	}
 
@@ -647,6 +883,9 @@ public:
 	 *
 	 * \param vec_key element
 	 *
+	 * \note a position written with this accessor is not tracked by a ghost_get with GHOST_AUTO_REUSE, use
+	 *       getPosWrite (or markPosChanged) in that case
+	 *
 	 * \return the position of the element in space
 	 *
 	 */
@@ -655,7 +894,6 @@ public:
 #ifdef SE_CLASS3
 		check_for_pos_nan_inf<prop::max_prop_real,prop::max_prop>(*this,vec_key.getKey());
 #endif
-
 		return v_pos.template get<0>(vec_key.getKey());
 	}
 
@@ -717,6 +955,9 @@ public:
 	 * \tparam id property id
 	 * \param vec_key vector element
 	 *
+	 * \note a property written with this accessor is not tracked by a ghost_get with GHOST_AUTO_REUSE, use
+	 *       getPropWrite (or markPropChanged) in that case
+	 *
 	 * \return return the selected property of the vector element
 	 *
 	 */
@@ -918,6 +1159,7 @@ public:
 #ifdef SE_CLASS3
 		se3.template write<prop::max_prop_real>(*this,vec_key.getKey());
 #endif
+		this->incPosVersion();
 
 		return v_pos.template get<0>(vec_key.getKey());
 	}
@@ -952,6 +1194,8 @@ public:
 	 */
 	template<unsigned int id> inline auto getPropWrite(vect_dist_key_dx vec_key) -> decltype(v_prp.template get<id>(vec_key.getKey()))
 	{
+		this->template markPropDirty<id>();
+
 #ifdef SE_CLASS3
 		se3.template write<id>(*this,vec_key.getKey());
 #endif
@@ -995,12 +1239,61 @@ public:
 
 		g_m++;
 
+		this->incPosVersion();
+
 #ifdef SE_CLASS3
 		for (size_t i = 0 ; i < prop::max_prop_real+1 ; i++)
 			v_prp.template get<prop::max_prop_real>(g_m-1)[i] = UNINITIALIZED;
 #endif
 	}
 
+	/*! \brief Add n local particles at once
+	 *
+	 * Like add, the particles are created at the end of the local particles and can also be outside the
+	 * processor domain (a map is required). Differently from add, the ghost particles are removed once
+	 * instead of being shifted at every insertion, so the cost is proportional to n. The new particles
+	 * are value-initialized. A ghost_get is required to get the ghost back
+	 *
+	 * \param n number of particles to add
+	 *
+	 * \return an iterator over the added particles
+	 *
+	 */
+	vector_dist_iterator addBatch(size_t n)
+	{
+		size_t start = g_m;
+
+		// the ghost part is overwritten
+		v_pos.resize(g_m + n);
+		v_prp.resize(g_m + n);
+
+		g_m += n;
+
+		// the memory of the new particles can contain the old ghost particles
+		Point<dim,St> pos_zero;
+		pos_zero.zero();
+		prop prp_zero = prop();
+
+		for (size_t j = start ; j < g_m ; j++)
+		{
+			v_pos.set(j,pos_zero);
+			v_prp.set(j,prp_zero);
+		}
+
+		this->lazy_map_invalidate();
+		this->incPosVersion();
+
+#ifdef SE_CLASS3
+		for (size_t j = start ; j < g_m ; j++)
+		{
+			for (size_t i = 0 ; i < prop::max_prop_real+1 ; i++)
+				v_prp.template get<prop::max_prop_real>(j)[i] = UNINITIALIZED;
+		}
+#endif
+
+		return vector_dist_iterator(start, g_m);
+	}
+
 #ifndef ONLY_READWRITE_GETTER
 
 	/*! \brief Get the position of the last element
@@ -1070,6 +1363,7 @@ public:
 #ifdef SE_CLASS3
 		se3.template write<prop::max_prop_real>(*this,g_m-1);
 #endif
+		this->incPosVersion();
 
 		return v_pos.template get<0>(g_m - 1);
 	}
@@ -1083,6 +1377,8 @@ public:
 	 */
 	template<unsigned int id> inline auto getLastPropWrite() -> decltype(v_prp.template get<id>(0))
 	{
+		this->template markPropDirty<id>();
+
 #ifdef SE_CLASS3
 		se3.template write<id>(*this,g_m-1);
 #endif
@@ -1410,6 +1706,268 @@ public:
 		}
 	}
 
+	/*! \brief Get the state of the incremental update of a cell-list
+	 *
+	 * The state is identified by the address of the cell-list and its number of cells, when it does not exist
+	 * it is created (replacing the oldest one when icl_max cell-lists are tracked)
+	 *
+	 * \param cell_list Cell list
+	 * \param found set to true if the state existed
+	 *
+	 * \return the state
+	 *
+	 */
+	template<typename CellL>
+	icl_state & get_icl_state(CellL & cell_list, bool & found)
+	{
+		auto & gi = cell_list.getGrid();
+
+		for (size_t i = 0 ; i < icl_st.size() ; i++)
+		{
+			icl_state & st = icl_st.get(i);
+
+			if (st.ptr != &cell_list)
+			{continue;}
+
+			found = true;
+			for (size_t j = 0 ; j < dim ; j++)
+			{found &= (st.div[j] == gi.size(j));}
+
+			if (found == false)
+			{
+				for (size_t j = 0 ; j < dim ; j++)
+				{st.div[j] = gi.size(j);}
+			}
+
+			return st;
+		}
+
+		size_t id;
+		if (icl_st.size() < icl_max)
+		{
+			id = icl_st.size();
+			icl_st.add();
+		}
+		else
+		{
+			id = icl_next;
+			icl_next = (icl_next + 1) % icl_max;
+		}
+
+		icl_state & st = icl_st.get(id);
+		st.ptr = &cell_list;
+		for (size_t j = 0 ; j < dim ; j++)
+		{st.div[j] = gi.size(j);}
+
+		found = false;
+		return st;
+	}
+
+	/*! \brief Move the particles of a cell-list that changed cell, and replace the ghost particles
+	 *
+	 * \param cell_list Cell list to update
+	 * \param st state of the last update of cell_list
+	 *
+	 * \return the number of domain particles that changed cell, -1 if the cell-list does not match st (it must
+	 *         be fully reconstructed)
+	 *
+	 */
+	template<typename CellL>
+	long int icl_update(CellL & cell_list, icl_state & st)
+	{
+#ifdef SE_CLASS3
+		se3.getNN();
+#endif
+
+		// check that the old ghost particles are where we left them
+		for (size_t i = g_m ; i < st.cell.size() ; i++)
+		{
+			size_t c = st.cell.get(i);
+
+			if (st.slot.get(i) >= cell_list.getNelements(c) || cell_list.get(c,st.slot.get(i)) != i)
+			{return -1;}
+		}
+
+		// remove the old ghost particles, only the cells that contain old and actual ghost particles are visited
+		if (icl_mark.size() != cell_list.getGrid().size())
+		{
+			icl_mark.resize(cell_list.getGrid().size());
+			for (size_t i = 0 ; i < icl_mark.size() ; i++)
+			{icl_mark.get(i) = 0;}
+		}
+
+		icl_gcell.clear();
+		icl_gnew.resize(v_pos.size() - g_m);
+
+		for (size_t i = g_m ; i < st.cell.size() ; i++)
+		{
+			size_t c = st.cell.get(i);
+
+			if (icl_mark.get(c) == 0)
+			{
+				icl_mark.get(c) = 1;
+				icl_gcell.add(c);
+			}
+		}
+
+		for (size_t i = g_m ; i < v_pos.size() ; i++)
+		{
+			Point<dim,St> xp = v_pos.template get<0>(i);
+			size_t c = cell_list.getCell(xp);
+			icl_gnew.get(i - g_m) = c;
+
+			if (icl_mark.get(c) == 0)
+			{
+				icl_mark.get(c) = 1;
+				icl_gcell.add(c);
+			}
+		}
+
+		for (size_t i = 0 ; i < icl_gcell.size() ; i++)
+		{
+			size_t c = icl_gcell.get(i);
+			icl_mark.get(c) = 0;
+
+			size_t j = 0;
+			while (j < cell_list.getNelements(c))
+			{
+				if (cell_list.get(c,j) >= g_m)
+				{
+					size_t last = cell_list.getNelements(c) - 1;
+					size_t q = cell_list.get(c,last);
+
+					cell_list.get(c,j) = q;
+					cell_list.remove(c,last);
+
+					if (q < g_m)
+					{st.slot.get(q) = j;}
+				}
+				else
+				{j++;}
+			}
+		}
+
+		// move the domain particles that changed cell
+		long int n_moved = 0;
+
+		for (size_t p = 0 ; p < g_m ; p++)
+		{
+			size_t c_old = st.cell.get(p);
+			size_t j = st.slot.get(p);
+			size_t n_old = cell_list.getNelements(c_old);
+
+			// the particle is not where we left it, the cell-list has been changed from outside
+			if (j >= n_old || cell_list.get(c_old,j) != p)
+			{return -1;}
+
+			Point<dim,St> xp = v_pos.template get<0>(p);
+			size_t c = cell_list.getCell(xp);
+
+			if (c == c_old)
+			{continue;}
+
+			size_t q = cell_list.get(c_old,n_old - 1);
+
+			if (q >= g_m)
+			{return -1;}
+
+			cell_list.get(c_old,j) = q;
+			st.slot.get(q) = j;
+			cell_list.remove(c_old,n_old - 1);
+
+			cell_list.addCell(c,p);
+			st.cell.get(p) = c;
+			st.slot.get(p) = cell_list.getNelements(c) - 1;
+
+			n_moved++;
+		}
+
+		// add the actual ghost particles
+		st.cell.resize(v_pos.size());
+		st.slot.resize(v_pos.size());
+
+		for (size_t i = g_m ; i < v_pos.size() ; i++)
+		{
+			size_t c = icl_gnew.get(i - g_m);
+
+			cell_list.addCell(c,i);
+			st.cell.get(i) = c;
+			st.slot.get(i) = cell_list.getNelements(c) - 1;
+		}
+
+		cell_list.set_gm(g_m);
+
+		return n_moved;
+	}
+
+	/*! \brief Update a cell list moving only the particles that changed cell
+	 *
+	 * For every cell-list (up to icl_max) the cell of every particle and its position inside the cell are remembered
+	 * between two calls. If the particles has not been reordered in the meanwhile (map, reorder, remove, add ...) only
+	 * the domain particles that changed cell are moved and the ghost particles are removed and added again (the ghost
+	 * can be changed by ghost_get), otherwise the cell list is fully reconstructed. Before a particle is used its
+	 * remembered position inside the cell is checked, when the cell-list has been changed from outside (a full update,
+	 * or a new cell-list assigned to the same object) the cell-list is fully reconstructed. Constructing other
+	 * cell-lists does not affect it. It work with the CPU CellList (Mem_fast, Mem_bal, Mem_mw), not with CellList_gen
+	 *
+	 * \tparam CellL CellList type
+	 *
+	 * \param cell_list Cell list to update
+	 *
+	 * \return the number of domain particles that changed cell (or the number of particles on a full reconstruction)
+	 *
+	 */
+	template<typename CellL>
+	size_t updateCellListIncremental(CellL & cell_list)
+	{
+		bool found = false;
+		icl_state & st = get_icl_state(cell_list,found);
+
+		long int n_moved = -1;
+
+		if (found == true && st.g_m == g_m && st.idx_version == this->getIdxVersion() &&
+		    cell_list.get_ndec() == getDecomposition().get_ndec())
+		{n_moved = icl_update(cell_list,st);}
+
+		if (n_moved < 0)
+		{
+			updateCellList(cell_list);
+
+			// the position of every particle inside the cells
+			size_t n_cell = cell_list.getGrid().size();
+
+			st.cell.resize(v_pos.size());
+			st.slot.resize(v_pos.size());
+
+			// a particle not stored in the cell-list never match its slot
+			for (size_t i = 0 ; i < v_pos.size() ; i++)
+			{
+				st.cell.get(i) = 0;
+				st.slot.get(i) = (size_t)-1;
+			}
+
+			for (size_t c = 0 ; c < n_cell ; c++)
+			{
+				for (size_t j = 0 ; j < cell_list.getNelements(c) ; j++)
+				{
+					size_t p = cell_list.get(c,j);
+					st.cell.get(p) = c;
+					st.slot.get(p) = j;
+				}
+			}
+
+			for (size_t j = 0 ; j < dim ; j++)
+			{st.div[j] = cell_list.getGrid().size(j);}
+
+			st.g_m = g_m;
+			st.idx_version = this->getIdxVersion();
+
+			return v_pos.size();
+		}
+
+		return n_moved;
+	}
+
 	/*! \brief Update a cell list using the stored particles
 	 *
 	 * \tparam CellL CellList type to construct
@@ -1644,31 +2202,129 @@ public:
 		return ver;
 	}
 
-	/*! \brief for each particle get the verlet list
+	/*! \brief Set the parameters of the Verlet list managed by the vector
+	 *
+	 * The Verlet list is built with radius r_cut + skin, it remain valid as far as no particle moved more than skin/2
 	 *
 	 * \param r_cut cut-off radius
-	 * \param ver Verlet to update
-	 * \param r_cut cutoff radius
-	 * \param opt option like VL_SYMMETRIC and VL_NON_SYMMETRIC or VL_CRS_SYMMETRIC
+	 * \param skin skin
 	 *
 	 */
-	template<typename Mem_type> void updateVerlet(VerletList<dim,St,Mem_type,shift<dim,St> > & ver, St r_cut, size_t opt = VL_NON_SYMMETRIC)
+	void setManagedVerlet(St r_cut, St skin)
 	{
-#ifdef SE_CLASS3
-		se3.getNN();
-#endif
+		ver_r_cut = r_cut;
+		ver_skin = skin;
+		ver_built = false;
+	}
 
-		if (opt == VL_SYMMETRIC)
+	/*! \brief Check if the managed Verlet list must be rebuilt (all processors give the same answer)
+	 *
+	 * It is true if on some processor a particle moved more than skin/2 from the last build. In this case
+	 * map() and ghost_get() must be called before getManagedVerlet(), otherwise a ghost_get(SKIP_LABELLING)
+	 * is enough to update the ghost and keep the indexes in the Verlet list valid
+	 *
+	 * Typical usage in an MD loop
+	 *
+	 * \code
+	 * if (vd.managedVerletRebuildRequired() == true)
+	 * {vd.map(); vd.ghost_get<>();}
+	 * else
+	 * {vd.ghost_get<>(SKIP_LABELLING);}
+	 *
+	 * auto & NN = vd.getManagedVerlet();
+	 * \endcode
+	 *
+	 * \return true if the Verlet list must be rebuilt
+	 *
+	 */
+	bool managedVerletRebuildRequired()
+	{
+		size_t rebuild = ver_built == false || ver_x0.size() != g_m || ver_idx_version != this->getIdxVersion();
+
+		if (rebuild == false)
 		{
-			auto & NN = ver.getInternalCellList();
+			St max_disp2 = 0;
 
-			// Here we have to check that the Box defined by the Cell-list is the same as the domain box of this
-			// processor. if it is not like that we have to completely reconstruct from stratch
-			bool to_reconstruct = NN.get_ndec() != getDecomposition().get_ndec();
+			long int n_thr = sfc_n_threads(g_m);
 
-			if (to_reconstruct == false)
-				ver.update(getDecomposition().getDomain(),r_cut,v_pos,g_m, opt);
-			else
+#ifdef _OPENMP
+			#pragma omp parallel for num_threads(n_thr) reduction(max:max_disp2) if (n_thr > 1)
+#endif
+			for (long int p = 0 ; p < (long int)g_m ; p++)
+			{
+				Point<dim,St> xp = v_pos.template get<0>(p);
+				St d2 = xp.distance2(ver_x0.get(p));
+
+				max_disp2 = (d2 > max_disp2)?d2:max_disp2;
+			}
+
+			rebuild = 4*max_disp2 > ver_skin*ver_skin;
+		}
+
+		Vcluster<Memory> & v_cl = create_vcluster<Memory>();
+
+		v_cl.max(rebuild);
+		v_cl.execute();
+
+		return rebuild != 0;
+	}
+
+	/*! \brief Get the Verlet list managed by the vector
+	 *
+	 * The Verlet list is built with radius r_cut + skin (see setManagedVerlet). It is rebuilt only if the particles
+	 * or the ghost particles changed indexes from the last build (map, reorder, ghost_get with labelling ...), so
+	 * with the pattern of managedVerletRebuildRequired it is rebuilt only when a particle moved more than skin/2
+	 *
+	 * \return the Verlet list
+	 *
+	 */
+	VerletList<dim,St,Mem_fast<>,shift<dim,St>,decltype(v_pos)> & getManagedVerlet()
+	{
+		if (ver_built == false || ver_g_m != g_m ||
+		    ver_idx_version != this->getIdxVersion() ||
+		    ver_gg_epoch != this->getGhostLabellingEpoch())
+		{
+			auto ver_tmp = getVerlet(ver_r_cut + ver_skin);
+			ver_m.swap(ver_tmp);
+
+			ver_x0.resize(g_m);
+			for (size_t p = 0 ; p < g_m ; p++)
+			{ver_x0.get(p) = v_pos.template get<0>(p);}
+
+			ver_built = true;
+			ver_g_m = g_m;
+			ver_idx_version = this->getIdxVersion();
+			ver_gg_epoch = this->getGhostLabellingEpoch();
+		}
+
+		return ver_m;
+	}
+
+	/*! \brief for each particle get the verlet list
+	 *
+	 * \param r_cut cut-off radius
+	 * \param ver Verlet to update
+	 * \param r_cut cutoff radius
+	 * \param opt option like VL_SYMMETRIC and VL_NON_SYMMETRIC or VL_CRS_SYMMETRIC
+	 *
+	 */
+	template<typename Mem_type> void updateVerlet(VerletList<dim,St,Mem_type,shift<dim,St> > & ver, St r_cut, size_t opt = VL_NON_SYMMETRIC)
+	{
+#ifdef SE_CLASS3
+		se3.getNN();
+#endif
+
+		if (opt == VL_SYMMETRIC)
+		{
+			auto & NN = ver.getInternalCellList();
+
+			// Here we have to check that the Box defined by the Cell-list is the same as the domain box of this
+			// processor. if it is not like that we have to completely reconstruct from stratch
+			bool to_reconstruct = NN.get_ndec() != getDecomposition().get_ndec();
+
+			if (to_reconstruct == false)
+				ver.update(getDecomposition().getDomain(),r_cut,v_pos,g_m, opt);
+			else
 			{
 				VerletList<dim,St,Mem_type,shift<dim,St> > ver_tmp;
 
@@ -1738,9 +2394,9 @@ public:
 	}
 
 
-	/*! \brief Construct a cell list starting from the stored particles and reorder a vector according to the Hilberts curve
+	/*! \brief Reorder the particles according to a space filling curve
 	 *
-	 * \tparam CellL CellList type to construct
+	 * \tparam CellL unused, kept for compatibility
 	 *
 	 * \param m an order of a hilbert curve
 	 *
@@ -1752,17 +2408,22 @@ public:
 	}
 
 
-	/*! \brief Construct a cell list starting from the stored particles and reorder a vector according to the Hilberts curve
+	/*! \brief Reorder the particles according to a space filling curve
 	 *
 	 * \warning it kill the ghost and invalidate cell-lists
 	 *
-	 *It differs from the reorder(m) for an additional parameter, in case the
-	 * domain + ghost is not big enough to contain additional padding particles, a Cell list
-	 * with bigger space can be created
-	 * (padding particles in general are particles added by the user out of the domains)
+	 * The processor box enlarged by enlarge is divided in 2^m cells per dimension. The key of every particle on the
+	 * curve is computed in parallel, the keys are sorted with a multi-threaded radix sort (stable, so particles in the
+	 * same cell keep their order) and the particles are permuted through buffers retained across calls
+	 *
+	 * (padding particles in general are particles added by the user out of the domains, they are assigned to the
+	 * nearest cell)
+	 *
+	 * \tparam CellL unused, kept for compatibility
 	 *
 	 * \param m order of a curve
-	 * \param enlarge In case of padding particles the cell list must be enlarged, like a ghost this parameter say how much must be enlarged
+	 * \param enlarge enlarge the processor box covered by the curve
+	 * \param opt type of curve
 	 *
 	 */
 	template<typename CellL=CellList_gen<dim,St,Process_keys_lin,Mem_bal<>,shift<dim,St> > >
@@ -1772,70 +2433,154 @@ public:
 		v_pos.resize(g_m);
 		v_prp.resize(g_m);
 
+		reorder_domain(m,enlarge,opt);
+	}
 
-		CellL cell_list;
+	/*! \brief Reorder the domain particles according to a space filling curve, the ghost particles are not touched
+	 *
+	 * \param m order of a curve
+	 * \param enlarge enlarge the processor box covered by the curve
+	 * \param opt type of curve
+	 *
+	 */
+	void reorder_domain(int32_t m, const Ghost<dim,St> & enlarge, reorder_opt opt)
+	{
+		this->lazy_map_invalidate();
+		this->incIdxVersion();
+		this->incPosVersion();
+
+		if (opt == reorder_opt::NO_REORDER)
+		{return;}
 
-		// calculate the parameters of the cell list
+		// the key of dim*m bits must fit in a 64 bit integer
+		if (m < 0 || dim*m > 62)
+		{
+			std::cerr << __FILE__ << ":" << __LINE__ << " Warning the order of the curve " << m << " is out of range, it will be set to " << 62/dim << std::endl;
+			m = 62/dim;
+		}
 
 		// get the processor bounding box
 		Box<dim,St> pbox = getDecomposition().getProcessorBounds();
 		// extend by the ghost
 		pbox.enlarge(enlarge);
 
-		size_t div[dim];
+		reorder_keys(pbox,m,opt);
+		sfc_radix_sort(sfc_buf,dim*m);
+		reorder_permute();
+	}
 
-		// Calculate the division array and the cell box
-		for (size_t i = 0 ; i < dim ; i++)
+	/*! \brief Locality metric of the local particles
+	 *
+	 * It is the mean distance between particles consecutive in memory. It is small after a reorder and it grows
+	 * as the particles mix
+	 *
+	 * \return the locality metric
+	 *
+	 */
+	double getLocalityMetric()
+	{
+		if (g_m < 2)
+		{return 0.0;}
+
+		double sum = 0.0;
+		long int n_thr = sfc_n_threads(g_m);
+
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(n_thr) reduction(+:sum) if (n_thr > 1)
+#endif
+		for (long int p = 1 ; p < (long int)g_m ; p++)
 		{
-			div[i] = 1 << m;
+			Point<dim,St> xp = v_pos.template get<0>(p);
+			Point<dim,St> xq = v_pos.template get<0>(p-1);
+
+			sum += xp.distance(xq);
 		}
 
-		cell_list.Initialize(pbox,div);
-		cell_list.set_gm(g_m);
+		return sum / (g_m - 1);
+	}
 
-		// for each particle add the particle to the cell list
+	/*! \brief Enable the automatic reorder of the particles
+	 *
+	 * After every map (map, map_list, map_wait, map_and_ghost_get) the locality metric (getLocalityMetric) is compared with the one measured after the
+	 * last reorder. The particles are reordered when it is bigger than threshold times the reference and the time
+	 * passed from the last reorder is at least amort times the measured cost of a reorder. The first map after this
+	 * call always reorder. The decision is collective: when at least one processor needs a reorder all the
+	 * processors reorder, so this function must be called on all the processors
+	 *
+	 * \param m order of the curve
+	 * \param opt type of curve
+	 * \param threshold degradation of the locality metric that trigger a reorder
+	 * \param amort minimum ratio between the time from the last reorder and the reorder cost
+	 *
+	 */
+	void setAutoReorder(int32_t m, reorder_opt opt = reorder_opt::HILBERT, double threshold = 2.0, double amort = 10.0)
+	{
+		ar_m = m;
+		ar_opt = opt;
+		ar_threshold = threshold;
+		ar_amort = amort;
+		ar_base = -1.0;
+	}
 
-		auto it = getIterator();
+	/*! \brief Disable the automatic reorder of the particles
+	 *
+	 */
+	void disableAutoReorder()
+	{
+		ar_opt = reorder_opt::NO_REORDER;
+	}
 
-		while (it.isNext())
-		{
-			auto key = it.get();
+	/*! \brief Check if the particles must be reordered by the auto-reorder policy and reorder them
+	 *
+	 * Every processor evaluate its own policy, the particles are reordered on all the processors when at least
+	 * one of them need it (one reduction). It is called at the end of every operation that migrate the particles
+	 *
+	 * \param keep_ghost reorder only the domain particles and keep the ghost (map_and_ghost_get)
+	 *
+	 * \return true if the particles has been reordered
+	 *
+	 */
+	bool auto_reorder_check(bool keep_ghost = false)
+	{
+		if (ar_opt == reorder_opt::NO_REORDER)
+		{return false;}
 
-			Point<dim,St> xp = this->getPos(key);
+		size_t need_reorder = 1;
 
-			cell_list.add(xp,key.getKey());
+		if (ar_base >= 0.0)
+		{
+			ar_time.stop();
+			ar_elapsed += ar_time.getwct();
+			ar_time.start();
 
-			++it;
+			if (getLocalityMetric() <= ar_threshold * ar_base || ar_elapsed < ar_amort * ar_t_reorder)
+			{need_reorder = 0;}
 		}
 
-		// Use cell_list to reorder v_pos
+		Vcluster<Memory> & v_cl = create_vcluster<Memory>();
 
-		//destination vector
-		openfpm::vector<Point<dim,St>> v_pos_dest;
-		openfpm::vector<prop> v_prp_dest;
+		v_cl.max(need_reorder);
+		v_cl.execute();
 
-		if (opt == reorder_opt::HILBERT)
-		{
-			grid_key_dx_iterator_hilbert<dim> h_it(m);
+		if (need_reorder == 0)
+		{return false;}
 
-			reorder_sfc<CellL,grid_key_dx_iterator_hilbert<dim>>(v_pos_dest,v_prp_dest,h_it,cell_list);
-		}
-		else if (opt == reorder_opt::LINEAR)
-		{
-			grid_sm<dim,void> gs(div);
-			grid_key_dx_iterator<dim> h_it(gs);
+		timer t;
+		t.start();
 
-			reorder_sfc<CellL,grid_key_dx_iterator<dim>>(v_pos_dest,v_prp_dest,h_it,cell_list);
-		}
+		if (keep_ghost == true)
+		{reorder_domain(ar_m,getDecomposition().getGhost(),ar_opt);}
 		else
-		{
-			// We do nothing, we second swap nullify the first
-			v_pos.swap(v_pos_dest);
-			v_prp.swap(v_prp_dest);
-		}
+		{reorder(ar_m,ar_opt);}
 
-		v_pos.swap(v_pos_dest);
-		v_prp.swap(v_prp_dest);
+		t.stop();
+
+		ar_t_reorder = t.getwct();
+		ar_base = getLocalityMetric();
+		ar_elapsed = 0.0;
+		ar_time.start();
+
+		return true;
 	}
 
 	/*! \brief Construct a cell list starting from the stored particles and reorder a vector according to the Hilberts curve
@@ -1858,6 +2603,10 @@ public:
 		v_pos.resize(g_m);
 		v_prp.resize(g_m);
 
+		this->lazy_map_invalidate();
+		this->incIdxVersion();
+		this->incPosVersion();
+
 		auto cell_list = getCellList<CellL>(r_cut);
 
 		// Use cell_list to reorder v_pos
@@ -2036,6 +2785,220 @@ public:
 		return vector_dist_iterator(0, g_m);
 	}
 
+	/*! \brief Call the kernel for all the pairs of particles (p,q) closer than r_cut, with p a domain particle
+	 *
+	 * The positions of the neighborhood q of p found with the cell-list are gathered in packets of SIMD width
+	 * (see pair_packet), where distance and cut-off are computed lane-wise. The pairs inside the cut-off are packed
+	 * in dense packets and the kernel is called for each of them, so a loop over the lanes of the packet is vectorized
+	 *
+	 * \code
+	 * vd.for_each_pair(NN,r_cut,[&](size_t p, pair_packet<3,double> & pk)
+	 * {
+	 *   double fx = 0.0;
+	 *
+	 *   #pragma omp simd reduction(+:fx)
+	 *   for (size_t l = 0 ; l < pk.width ; l++)
+	 *   {
+	 *     double rn3 = pk.r2[l]*pk.r2[l]*pk.r2[l];
+	 *     fx += pk.mask[l] * (2.0*sigma12 / (rn3*rn3*pk.r2[l]) - sigma6 / (rn3*pk.r2[l])) * pk.dx[0][l];
+	 *   }
+	 *
+	 *   vd.template getProp<force>(p)[0] += 24.0*fx;
+	 * });
+	 * \endcode
+	 *
+	 * \param NN Cell-list
+	 * \param r_cut cut-off radius
+	 * \param kernel function to call, signature void(size_t, pair_packet<dim,St> &)
+	 *
+	 */
+	template<typename CellL, typename kernel_f> void for_each_pair(CellL & NN, St r_cut, kernel_f kernel)
+	{
+#ifdef SE_CLASS3
+		se3.getIterator();
+#endif
+
+		St r_cut2 = r_cut*r_cut;
+
+		// pk is passed to the kernel, pc gather the raw positions of the candidate neighborhood
+		pair_packet<dim,St> pk;
+		pair_packet<dim,St> pc;
+
+		for (size_t p = 0 ; p < g_m ; p++)
+		{
+			Point<dim,St> xp = v_pos.template get<0>(p);
+			pk.n = 0;
+			pc.n = 0;
+
+			// distances of the candidates computed lane-wise, the ones inside r_cut are moved in pk
+			auto flush = [&]()
+			{
+				pc.distance(xp,r_cut2,p);
+
+				for (size_t l = 0 ; l < pc.n ; l++)
+				{
+					if (pc.mask[l] == 0)
+					{continue;}
+
+					pk.add_lane(pc,l);
+
+					if (pk.full() == true)
+					{
+						kernel(p,pk);
+						pk.n = 0;
+					}
+				}
+
+				pc.n = 0;
+			};
+
+			auto Np = NN.getNNIterator(NN.getCell(xp));
+
+			while (Np.isNext())
+			{
+				auto q = Np.get();
+
+				pc.add_pos(q,v_pos.template get<0>(q));
+
+				if (pc.full() == true)
+				{flush();}
+
+				++Np;
+			}
+
+			if (pc.n != 0)
+			{flush();}
+
+			// the tail
+			if (pk.n != 0)
+			{
+				pk.pad();
+				kernel(p,pk);
+			}
+		}
+	}
+
+	/*! \brief Get an iterator that traverse the block of domain particles of the calling thread
+	 *
+	 * It must be called inside an OpenMP parallel region, the domain particles are divided in contiguous blocks,
+	 * one for each thread of the team. Outside a parallel region it traverse all the domain particles.
+	 * Inside the parallel region use only the NC accessors (getPosNC, getPropNC), and call markPosChanged /
+	 * markPropChanged after it if the next ghost_get use GHOST_AUTO_REUSE
+	 *
+	 * \code
+	 * #pragma omp parallel
+	 * {
+	 *   auto it = vd.getDomainIteratorParallel();
+	 *
+	 *   while (it.isNext())
+	 *   {...}
+	 * }
+	 * \endcode
+	 *
+	 * \return an iterator
+	 *
+	 */
+	vector_dist_iterator getDomainIteratorParallel() const
+	{
+#ifdef SE_CLASS3
+		se3.getIterator();
+#endif
+
+		size_t t = 0;
+		size_t nt = 1;
+
+#ifdef _OPENMP
+		t = omp_get_thread_num();
+		nt = omp_get_num_threads();
+#endif
+
+		return vector_dist_iterator(g_m * t / nt, g_m * (t+1) / nt);
+	}
+
+	/*! \brief Call f(key) for every domain particle with all the threads
+	 *
+	 * The particles are distributed to the threads in chunks with a dynamic schedule, so a thread that
+	 * finish early take the next chunk. f must only write the particle key (or use thread private data).
+	 * Inside f use only the NC accessors (getPosNC, getPropNC), the Read and Write accessors update shared
+	 * state (SE_CLASS3 and ghost_get tracking). Positions and properties are marked as changed once before
+	 * the loop
+	 *
+	 * \param f function to call, signature void(vect_dist_key_dx)
+	 * \param chunk number of particles assigned to a thread at once
+	 *
+	 */
+	template<typename lambda_f> void parallel_for_domain(lambda_f f, size_t chunk = 1024)
+	{
+#ifdef SE_CLASS3
+		se3.getIterator();
+#endif
+
+		this->incPosVersion();
+		this->markAllPropDirty();
+
+		long int n = g_m;
+
+#ifdef _OPENMP
+		#pragma omp parallel for schedule(dynamic,chunk) if (n > (long int)chunk)
+#endif
+		for (long int p = 0 ; p < n ; p++)
+		{f(vect_dist_key_dx(p));}
+	}
+
+	/*! \brief Call f(key) for every domain particle with all the threads, traversing the cells of a cell-list
+	 *
+	 * The domain cells are distributed to the threads in chunks with a dynamic schedule, particles in the same cell
+	 * are processed by the same thread, so the neighborhood of consecutive particles stay in the cache of the thread.
+	 * f must only write the particle key (or use thread private data) and use only the NC accessors (getPosNC,
+	 * getPropNC), like in parallel_for_domain. The cell-list must satisfy the same requirements of getDomainIteratorCells
+	 *
+	 * \param NN Cell-list
+	 * \param f function to call, signature void(vect_dist_key_dx)
+	 * \param chunk number of cells assigned to a thread at once
+	 *
+	 */
+	template<typename CellList, typename lambda_f> void parallel_for_domain_cells(CellList & NN, lambda_f f, size_t chunk = 16)
+	{
+#ifdef SE_CLASS3
+		se3.getIterator();
+#endif
+
+		this->incPosVersion();
+		this->markAllPropDirty();
+
+		// Shift
+		grid_key_dx<dim> shift;
+
+		// Add padding
+		for (size_t i = 0 ; i < dim ; i++)
+			shift.set_d(i,NN.getPadding(i));
+
+		grid_sm<dim,void> gs = NN.getInternalGrid();
+
+		getDecomposition().setNNParameters(shift,gs);
+
+		openfpm::vector<size_t> & dom_cells = getDecomposition().getDomainCells();
+		long int n_cells = dom_cells.size();
+		size_t g_m_ = g_m;
+
+#ifdef _OPENMP
+		#pragma omp parallel for schedule(dynamic,chunk) if (n_cells > (long int)chunk)
+#endif
+		for (long int c = 0 ; c < n_cells ; c++)
+		{
+			size_t cell = dom_cells.get(c);
+			size_t n_ele = NN.getNelements(cell);
+
+			for (size_t j = 0 ; j < n_ele ; j++)
+			{
+				size_t p = NN.get(cell,j);
+
+				if (p < g_m_)
+				{f(vect_dist_key_dx(p));}
+			}
+		}
+	}
+
 #ifdef CUDA_GPU
 
 	/*! \brief Get an iterator that traverse the particles in the domain
@@ -2271,12 +3234,19 @@ public:
 	 */
 	template<unsigned int ... prp> void map_list(size_t opt = NONE)
 	{
+#ifdef SE_CLASS1
+		check_no_ghost_put_in_flight("map_list");
+#endif
+
 #ifdef SE_CLASS3
 		se3.map_pre();
 #endif
 
 		this->template map_list_<prp...>(v_pos,v_prp,g_m,opt);
 
+		if (!(opt & RUN_ON_DEVICE))
+		{auto_reorder_check();}
+
 #ifdef CUDA_GPU
 		this->update(this->toKernel());
 #endif
@@ -2295,17 +3265,115 @@ public:
 	 * elements out the local processor. Or just after initialization if each processor
 	 * contain non local particles
 	 *
-	 * \param opt options
+	 * \param opt options. MAP_LOCAL receive only from the neighborhood processors,
+	 *            MAP_SEND_ARENA pack the outgoing particles into one contiguous retained arena,
+	 *            MAP_LAZY relabel only the particles that moved more than their distance from the
+	 *            sub-domain border since the last lazy map, and skip the communication if no particle migrate
 	 *
 	 */
 	template<typename obp = KillParticle> void map(size_t opt = NONE)
 	{
+#ifdef SE_CLASS1
+		check_no_ghost_put_in_flight("map");
+#endif
+
 #ifdef SE_CLASS3
 		se3.map_pre();
 #endif
 
 		this->template map_<obp>(v_pos,v_prp,g_m,opt);
 
+		if (!(opt & RUN_ON_DEVICE))
+		{auto_reorder_check();}
+
+#ifdef CUDA_GPU
+		this->update(this->toKernel());
+#endif
+
+#ifdef SE_CLASS3
+		se3.map_post();
+#endif
+	}
+
+	/*! \brief It start to move all the particles that does not belong to the local processor to the respective processor
+	 *
+	 * It is the asynchronous version of map. At return the particles that migrate has been removed and the
+	 * communication has been started. The particles that stay on this processor can be used (size_local()
+	 * return their number) while the communication is in flight. The incoming particles are added with map_wait()
+	 *
+	 * \warning No other map can be started before map_wait(), and ghost_get must be called after map_wait()
+	 *
+	 * \tparam out of bound policy it specify what to do when the particles are detected out of bound
+	 *
+	 * \param opt options
+	 *
+	 */
+	template<typename obp = KillParticle> void Imap(size_t opt = NONE)
+	{
+#ifdef SE_CLASS1
+		check_no_ghost_put_in_flight("Imap");
+#endif
+
+#ifdef SE_CLASS3
+		se3.map_pre();
+#endif
+
+		this->template Imap_<obp>(v_pos,v_prp,g_m,opt);
+	}
+
+	/*! \brief It wait the completion of a map started with Imap() and add the incoming particles
+	 *
+	 * \param opt options
+	 *
+	 */
+	void map_wait(size_t opt = NONE)
+	{
+		this->map_wait_(v_pos,v_prp,g_m,opt);
+
+		if (!(opt & RUN_ON_DEVICE))
+		{auto_reorder_check();}
+
+#ifdef CUDA_GPU
+		this->update(this->toKernel());
+#endif
+
+#ifdef SE_CLASS3
+		se3.map_post();
+#endif
+	}
+
+	/*! \brief It move the particles to the owner processors and create the ghost particles in a single communication round
+	 *
+	 * It produce the same result of map() followed by ghost_get() (with all the properties), but the particles are
+	 * labelled once and migrating and ghost particles are sent with the same messages
+	 *
+	 * \note the ghost particles always carry all the properties, because they share the message with the migrating
+	 *       particles. When only few properties are needed on the ghost map() followed by ghost_get<prp...>() can
+	 *       produce less traffic
+	 *
+	 * \warning the following ghost_get cannot use SKIP_LABELLING and ghost_put require a ghost_get first
+	 *
+	 * \tparam out of bound policy it specify what to do when the particles are detected out of bound
+	 *
+	 * \param opt options
+	 *
+	 */
+	template<typename obp = KillParticle> void map_and_ghost_get(size_t opt = NONE)
+	{
+#ifdef SE_CLASS1
+		check_no_ghost_put_in_flight("map_and_ghost_get");
+#endif
+
+#ifdef SE_CLASS3
+		se3.map_pre();
+#endif
+
+		this->template map_and_ghost_get_<obp>(v_pos,v_prp,g_m,opt);
+
+		// the ghost is not labelled for ghost_put, reordering the domain particles keep it valid
+		if (!(opt & RUN_ON_DEVICE))
+		{auto_reorder_check(true);}
+
 #ifdef CUDA_GPU
 		this->update(this->toKernel());
 #endif
@@ -2319,7 +3387,15 @@ public:
 	 *
 	 * \tparam prp list of properties to get synchronize
 	 *
-	 * \param opt options WITH_POSITION, it send also the positional information of the particles
+	 * \param opt options WITH_POSITION, it send also the positional information of the particles,
+	 *            GHOST_REDUCED_PRECISION the double properties are sent as float (positions are always sent
+	 *            in full precision), GHOST_AUTO_REUSE reuse the labelling of the previous ghost_get if no
+	 *            processor changed its positions (and skip the communication if also the requested properties
+	 *            did not change). It require that after the previous ghost_get the positions are written only
+	 *            with getPosWrite, getLastPosWrite, the operations of vector_dist (map, add, remove, ...) or are
+	 *            followed by markPosChanged, and the properties only with getPropWrite, getLastPropWrite or
+	 *            followed by markPropChanged. Writes through getPos, getProp, the NC accessors, getPosVector
+	 *            or a reference kept from a previous access are not detected
 	 *
 	 */
 	template<int ... prp> inline void ghost_get(size_t opt = WITH_POSITION)
@@ -2338,6 +3414,12 @@ public:
 		se3.template ghost_get_pre<prp...>(opt);
 #endif
 
+#ifdef SE_CLASS1
+		// the merge on device use the labelling of the ghost_get
+		if (opt & RUN_ON_DEVICE)
+		{check_no_ghost_put_in_flight("ghost_get");}
+#endif
+
 		this->template ghost_get_<GHOST_SYNC,prp...>(v_pos,v_prp,g_m,opt);
 
 #ifdef CUDA_GPU
@@ -2352,6 +3434,27 @@ public:
 #endif
 	}
 
+	/*! \brief It synchronize the properties and position of the ghost particles labelling only the particles near the processor border
+	 *
+	 * Same as ghost_get, but only the particles in the cells of cl that intersect the internal ghost boxes are labelled,
+	 * turning the labelling from O(N) to O(surface). The result is the same of ghost_get
+	 *
+	 * \warning cl must be constructed (or updated) on the actual particle positions, after the last map()
+	 *
+	 * \tparam prp list of properties to get synchronize
+	 *
+	 * \param cl Cell-list
+	 * \param opt options WITH_POSITION, it send also the positional information of the particles
+	 *
+	 */
+	template<int ... prp, typename CellL> inline void ghost_get_skin(CellL & cl, size_t opt = WITH_POSITION)
+	{
+		if (!(opt & SKIP_LABELLING) && !(opt & RUN_ON_DEVICE))
+		{this->ghost_candidates_from_cells(v_pos,g_m,cl);}
+
+		ghost_get<prp...>(opt);
+	}
+
 
 	/*! \brief It synchronize the properties and position of the ghost particles
 	 *
@@ -2425,12 +3528,53 @@ public:
 	 */
 	template<template<typename,typename> class op, int ... prp> inline void ghost_put(size_t opt_ = NONE)
 	{
+#ifdef SE_CLASS1
+		check_no_ghost_put_in_flight("ghost_put");
+#endif
+
 #ifdef SE_CLASS3
 		se3.template ghost_put<prp...>();
 #endif
 		this->template ghost_put_<op,prp...>(v_pos,v_prp,g_m,opt_);
 	}
 
+	/*! \brief It start to merge the ghost particles properties back to the real particles without waiting
+	 *
+	 * The contributions of the other processors are merged with op in ghost_put_wait. In the meanwhile the
+	 * properties prp of the particles that are not ghost of other processors (the interior) can be used,
+	 * and ghost_get can be called (not on device). map, ghost_put and a second Ighost_put must wait
+	 *
+	 * \tparam op which kind of operation to apply
+	 * \tparam prp list of properties to merge
+	 *
+	 * \param opt_ options. It must be the same passed to ghost_put_wait
+	 *
+	 */
+	template<template<typename,typename> class op, int ... prp> inline void Ighost_put(size_t opt_ = NONE)
+	{
+#ifdef SE_CLASS1
+		check_no_ghost_put_in_flight("Ighost_put");
+#endif
+
+#ifdef SE_CLASS3
+		se3.template ghost_put<prp...>();
+#endif
+		this->template Ighost_put_<op,prp...>(v_pos,v_prp,g_m,opt_);
+	}
+
+	/*! \brief It wait the completion of a ghost_put started with Ighost_put
+	 *
+	 * \tparam op which kind of operation to apply (the same of Ighost_put)
+	 * \tparam prp list of properties to merge (the same of Ighost_put)
+	 *
+	 * \param opt_ options (the same of Ighost_put)
+	 *
+	 */
+	template<template<typename,typename> class op, int ... prp> inline void ghost_put_wait(size_t opt_ = NONE)
+	{
+		this->template ghost_put_wait_<op,prp...>(v_pos,v_prp,g_m,opt_);
+	}
+
 	/*! \brief Remove a set of elements from the distributed vector
 	 *
 	 * \warning keys must be sorted
@@ -2445,6 +3589,10 @@ public:
 		v_prp.remove(keys, start);
 
 		g_m -= keys.size();
+
+		this->lazy_map_invalidate();
+		this->incIdxVersion();
+		this->incPosVersion();
 	}
 
 	/*! \brief Remove one element from the distributed vector
@@ -2458,6 +3606,203 @@ public:
 		v_prp.remove(key);
 
 		g_m--;
+
+		this->lazy_map_invalidate();
+		this->incIdxVersion();
+		this->incPosVersion();
+	}
+
+	/*! \brief Remove all the particles p with mask.get(p) != 0
+	 *
+	 * Positions and properties are compacted in one parallel pass, the ghost particles are dropped.
+	 * With REMOVE_STABLE the remaining particles keep their order, with REMOVE_UNSTABLE the removed
+	 * particles are replaced by the last particles of the vector, so only these are moved
+	 *
+	 * \param mask for each domain particle 1 to remove it, 0 to keep it (at least size_local() elements)
+	 * \param opt REMOVE_STABLE or REMOVE_UNSTABLE
+	 *
+	 */
+	void removeMarked(openfpm::vector<unsigned char> & mask, size_t opt = REMOVE_STABLE)
+	{
+#ifdef SE_CLASS1
+		if (mask.size() < g_m)
+		{
+			std::cerr << __FILE__ << ":" << __LINE__ << " Error the mask has " << mask.size() << " elements, but there are " << g_m << " domain particles" << std::endl;
+			ACTION_ON_ERROR(VECTOR_DIST_ERROR_OBJECT);
+		}
+#endif
+
+		long int n_thr = sfc_n_threads(g_m);
+
+		// count the particles to keep for each chunk
+		sfc_buf.cnt.resize(n_thr+1);
+		sfc_buf.cnt.get(0) = 0;
+
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+		for (long int t = 0 ; t < n_thr ; t++)
+		{
+			size_t n_keep = 0;
+			for (size_t p = g_m*t / n_thr ; p < g_m*(t+1) / n_thr ; p++)
+			{n_keep += (mask.get(p) == 0);}
+
+			sfc_buf.cnt.get(t+1) = n_keep;
+		}
+
+		for (long int t = 0 ; t < n_thr ; t++)
+		{sfc_buf.cnt.get(t+1) += sfc_buf.cnt.get(t);}
+
+		size_t n_keep = sfc_buf.cnt.get(n_thr);
+
+		if (opt == REMOVE_STABLE)
+		{
+			// list of the particles to keep
+			sfc_buf.id.resize(n_keep);
+
+#ifdef _OPENMP
+			#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+			for (long int t = 0 ; t < n_thr ; t++)
+			{
+				size_t k = sfc_buf.cnt.get(t);
+				for (size_t p = g_m*t / n_thr ; p < g_m*(t+1) / n_thr ; p++)
+				{
+					if (mask.get(p) == 0)
+					{sfc_buf.id.get(k++) = p;}
+				}
+			}
+
+			g_m = n_keep;
+			reorder_permute();
+
+			v_pos.resize(g_m);
+			v_prp.resize(g_m);
+		}
+		else
+		{
+			// the holes before n_keep are filled with the kept particles after n_keep. Every chunk
+			// write its holes and sources at the offsets given by the prefix sums of their counts
+			openfpm::vector<size_t> & cnt_h = sfc_buf.cnt;
+			openfpm::vector<size_t> & cnt_s = sfc_buf.key_tmp;
+
+			cnt_h.resize(n_thr+1);
+			cnt_s.resize(n_thr+1);
+			cnt_h.get(0) = 0;
+			cnt_s.get(0) = 0;
+
+#ifdef _OPENMP
+			#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+			for (long int t = 0 ; t < n_thr ; t++)
+			{
+				size_t n_h = 0;
+				size_t n_s = 0;
+				for (size_t p = g_m*t / n_thr ; p < g_m*(t+1) / n_thr ; p++)
+				{
+					if (p < n_keep)
+					{n_h += (mask.get(p) != 0);}
+					else
+					{n_s += (mask.get(p) == 0);}
+				}
+
+				cnt_h.get(t+1) = n_h;
+				cnt_s.get(t+1) = n_s;
+			}
+
+			for (long int t = 0 ; t < n_thr ; t++)
+			{
+				cnt_h.get(t+1) += cnt_h.get(t);
+				cnt_s.get(t+1) += cnt_s.get(t);
+			}
+
+			// the number of holes is equal to the number of sources
+			long int n_move = cnt_h.get(n_thr);
+
+			sfc_buf.id.resize(n_move);
+			sfc_buf.id_tmp.resize(n_move);
+
+#ifdef _OPENMP
+			#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+			for (long int t = 0 ; t < n_thr ; t++)
+			{
+				size_t k_h = cnt_h.get(t);
+				size_t k_s = cnt_s.get(t);
+				for (size_t p = g_m*t / n_thr ; p < g_m*(t+1) / n_thr ; p++)
+				{
+					if (p < n_keep)
+					{
+						if (mask.get(p) != 0)
+						{sfc_buf.id.get(k_h++) = p;}
+					}
+					else if (mask.get(p) == 0)
+					{sfc_buf.id_tmp.get(k_s++) = p;}
+				}
+			}
+
+			n_thr = sfc_n_threads(n_move);
+
+#ifdef _OPENMP
+			#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+			for (long int i = 0 ; i < n_move ; i++)
+			{
+				v_pos.get(sfc_buf.id.get(i)) = v_pos.get(sfc_buf.id_tmp.get(i));
+				v_prp.get(sfc_buf.id.get(i)) = v_prp.get(sfc_buf.id_tmp.get(i));
+			}
+
+			g_m = n_keep;
+			v_pos.resize(g_m);
+			v_prp.resize(g_m);
+		}
+
+		this->lazy_map_invalidate();
+		this->incIdxVersion();
+		this->incPosVersion();
+	}
+
+	/*! \brief Remove a set of particles, the keys does not need to be sorted
+	 *
+	 * see removeMarked, with REMOVE_STABLE the remaining particles are permuted one property at a time
+	 *
+	 * \param keys particles to remove (duplicates are allowed), they must be domain particles
+	 * \param opt REMOVE_STABLE or REMOVE_UNSTABLE
+	 *
+	 */
+	void removeKeys(openfpm::vector<size_t> & keys, size_t opt = REMOVE_STABLE)
+	{
+		rm_mask.resize(g_m);
+
+		long int n_thr = sfc_n_threads(g_m);
+
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+		for (long int p = 0 ; p < (long int)g_m ; p++)
+		{rm_mask.get(p) = 0;}
+
+#ifdef SE_CLASS1
+		for (size_t i = 0 ; i < keys.size() ; i++)
+		{
+			if (keys.get(i) >= g_m)
+			{
+				std::cerr << __FILE__ << ":" << __LINE__ << " Error the key " << keys.get(i) << " is not a domain particle, there are " << g_m << " domain particles" << std::endl;
+				ACTION_ON_ERROR(VECTOR_DIST_ERROR_OBJECT);
+			}
+		}
+#endif
+
+		long int n_thr_k = sfc_n_threads(keys.size());
+
+		// duplicated keys write the same value
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(n_thr_k) if (n_thr_k > 1)
+#endif
+		for (long int i = 0 ; i < (long int)keys.size() ; i++)
+		{rm_mask.get(keys.get(i)) = 1;}
+
+		removeMarked(rm_mask,opt);
 	}
 
 	/*! \brief Add the computation cost on the decomposition coming
@@ -2562,6 +3907,10 @@ public:
 		HDF5_reader<VECTOR_DIST> h5l;
 
 		h5l.load(filename,v_pos,v_prp,g_m);
+
+		this->lazy_map_invalidate();
+		this->incIdxVersion();
+		this->incPosVersion();
 	}
 
 	/*! \brief Reserve space for the internal vectors
@@ -2642,6 +3991,8 @@ public:
 	{
 		v_pos.resize(g_m);
 		v_prp.resize(g_m);
+
+		this->incPosVersion();
 	}
 
 	/*! \brief Resize the vector (locally)
@@ -2660,6 +4011,10 @@ public:
 
 		g_m = rs;
 
+		this->lazy_map_invalidate();
+		this->incIdxVersion();
+		this->incPosVersion();
+
 #ifdef CUDA_GPU
 		this->update(this->toKernel());
 #endif
@@ -2790,7 +4145,35 @@ public:
 		return v_pos;
 	}
 
+	/*! \brief Signal that the positions of the local particles have been changed
+	 *
+	 * It is needed only when the positions are written without the Write accessors and the next
+	 * ghost_get use GHOST_AUTO_REUSE
+	 *
+	 */
+	void markPosChanged()
+	{
+		this->incPosVersion();
+	}
+
+	/*! \brief Signal that the properties prp of the local particles have been changed
+	 *
+	 * It is needed only when the properties are written without the Write accessors and the next
+	 * ghost_get use GHOST_AUTO_REUSE
+	 *
+	 * \tparam prp properties
+	 *
+	 */
+	template<unsigned int ... prp> void markPropChanged()
+	{
+		int dummy[] = {0, (this->template markPropDirty<prp>(),0)...};
+		(void)dummy;
+	}
+
 	/*! \brief return the position vector of all the particles
+	 *
+	 * \note the writes through the returned reference are not tracked by a ghost_get with GHOST_AUTO_REUSE,
+	 *       call markPosChanged after them
 	 *
 	 * \return the particle position vector
 	 *
@@ -2817,6 +4200,7 @@ public:
 	 */
 	openfpm::vector<prop,Memory,layout_base> & getPropVector()
 	{
+		this->markAllPropDirty();
 		return v_prp;
 	}
 
@@ -2884,6 +4268,106 @@ public:
 		return sz;
 	}
 
+	/*! \brief Give a unique global id to the domain particles with local index >= start
+	 *
+	 * The id is written in the property gid and it move with the particle in map(), reorder() and the
+	 * ghost_get that transfer gid. The offset of every processor is calculated with a prefix sum, the next call
+	 * continue the numbering, so particles added later get new ids
+	 *
+	 * \tparam gid property where to store the global id (size_t)
+	 *
+	 * \param start first particle to number
+	 *
+	 */
+	template<unsigned int gid> void initGlobalIds(size_t start = 0)
+	{
+		Vcluster<Memory> & v_cl = create_vcluster<Memory>();
+
+		size_t n = (g_m > start)?g_m - start:0;
+		size_t offset = 0;
+		size_t tot = 0;
+
+		MPI_Exscan(&n,&offset,1,MPI_UNSIGNED_LONG,MPI_SUM,v_cl.getMPIComm());
+		MPI_Allreduce(&n,&tot,1,MPI_UNSIGNED_LONG,MPI_SUM,v_cl.getMPIComm());
+
+		// MPI_Exscan leave offset undefined on the first processor
+		if (v_cl.getProcessUnitID() == 0)
+		{offset = 0;}
+
+		offset += gid_next;
+		gid_next += tot;
+
+		long int n_thr = sfc_n_threads(n);
+
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+		for (long int i = 0 ; i < (long int)n ; i++)
+		{v_prp.template get<gid>(start + i) = offset + i;}
+
+		this->template markPropDirty<gid>();
+		gid_built = false;
+	}
+
+	/*! \brief Get the index from global id to local index
+	 *
+	 * It contain the domain particles and the ghost particles (if gid has been transferred after the last
+	 * ghost labelling), a domain particle has the precedence over the ghost copies of itself. The index is rebuilt in
+	 * O(n) only when the particles changed indexes from the last call (map, reorder, remove, ghost labelling ...).
+	 * Because every map change the indexes, in a simulation loop the index is rebuilt once per map, the rebuild is
+	 * multi-threaded
+	 *
+	 * \code
+	 * auto & idx = vd.template getGlobalIdIndex<gid>();
+	 *
+	 * size_t q = idx.find(bond_partner_id);
+	 * if (q != gid_index::empty)
+	 * {...}
+	 * \endcode
+	 *
+	 * \tparam gid property where the global id is stored
+	 *
+	 * \return the index
+	 *
+	 */
+	template<unsigned int gid> const gid_index & getGlobalIdIndex()
+	{
+		// ghost particles without a valid gid are not indexed
+		size_t n = (this->template isGhostPropValid<gid>() == true)?v_pos.size():g_m;
+
+		if (gid_built == false || gid_g_m != g_m || gid_size != n ||
+		    gid_idx_version != this->getIdxVersion() ||
+		    gid_gg_epoch != this->getGhostLabellingEpoch())
+		{
+			gid_idx.reset(n);
+
+			// the domain particles are inserted before the ghost to take the precedence
+			long int n_thr = sfc_n_threads(g_m);
+
+#ifdef _OPENMP
+			#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+			for (long int p = 0 ; p < (long int)g_m ; p++)
+			{gid_idx.insert_atomic(v_prp.template get<gid>(p),p);}
+
+			n_thr = sfc_n_threads(n - g_m);
+
+#ifdef _OPENMP
+			#pragma omp parallel for num_threads(n_thr) if (n_thr > 1)
+#endif
+			for (long int p = g_m ; p < (long int)n ; p++)
+			{gid_idx.insert_atomic(v_prp.template get<gid>(p),p);}
+
+			gid_built = true;
+			gid_g_m = g_m;
+			gid_size = n;
+			gid_idx_version = this->getIdxVersion();
+			gid_gg_epoch = this->getGhostLabellingEpoch();
+		}
+
+		return gid_idx;
+	}
+
 	/*! \brief Get a special particle iterator able to iterate across particles using
 	 *         symmetric crossing scheme
 	 *
@@ -2957,6 +4441,83 @@ public:
 		return openfpm::vector_key_iterator_seq<typename vrl::Mem_type_type::local_index_type>(NN.getParticleSeq());
 	}
 
+	/*! \brief Iterate across particles using the symmetric crossing scheme with all the threads
+	 *
+	 * Calling f(p,acc) for each particle p of getParticleIteratorCRS(NN). The contributions to the property prp
+	 * of p and of its neighborhood must be added in acc (acc.get(q)[i] += ...), that is private to the thread, so
+	 * no atomics are needed. At the end the buffers of all threads are added to the property prp of
+	 * the domain and ghost particles, that must be set before (typically to zero), then a ghost_put<add_,prp>
+	 * complete the calculation. Every thread process a contiguous block of particles, so (with particles ordered
+	 * in space) it access a narrow range of particles, and only this range is reduced. The buffers are kept
+	 * between the calls
+	 *
+	 * \code
+	 * vd.template parallel_for_CRS<force>(NN,[&](size_t p, auto & acc)
+	 * {
+	 *   auto Np = NN.template getNNIterator<NO_CHECK>(p);
+	 *
+	 *   while (Np.isNext())
+	 *   {
+	 *     ...
+	 *     acc.get(p)[0] += f.get(0);
+	 *     acc.get(q)[0] -= f.get(0);
+	 *     ...
+	 *   }
+	 * });
+	 * \endcode
+	 *
+	 * \tparam prp property to accumulate (scalar or one dimensional array)
+	 *
+	 * \param NN Verlet list created with getVerletCrs
+	 * \param f function to call, signature void(size_t, thread_acc_view &)
+	 *
+	 */
+	template<unsigned int prp, typename vrl, typename lambda_f> void parallel_for_CRS(vrl & NN, lambda_f f)
+	{
+#ifdef SE_CLASS1
+		if (!(opt & BIND_DEC_TO_GHOST))
+		{
+			std::cerr << __FILE__ << ":" << __LINE__ << " Error the vector has been constructed without BIND_DEC_TO_GHOST, parallel_for_CRS require the vector to be constructed with BIND_DEC_TO_GHOST option " << std::endl;
+			ACTION_ON_ERROR(VECTOR_DIST_ERROR_OBJECT);
+		}
+#endif
+
+		typedef typename boost::mpl::at<typename prop::type,boost::mpl::int_<prp>>::type p_type;
+
+		auto & seq = NN.getParticleSeq();
+		long int n = seq.size();
+
+		size_t n_thr = 1;
+#ifdef _OPENMP
+		n_thr = omp_get_max_threads();
+#endif
+
+		vector_dist_thread_acc<p_type> acc(crs_acc_mem);
+		acc.init(n_thr,v_pos.size());
+
+#ifdef _OPENMP
+		#pragma omp parallel num_threads(n_thr)
+#endif
+		{
+			size_t t = 0;
+#ifdef _OPENMP
+			t = omp_get_thread_num();
+#endif
+
+			auto acc_t = acc.getView(t);
+
+#ifdef _OPENMP
+			#pragma omp for schedule(static)
+#endif
+			for (long int i = 0 ; i < n ; i++)
+			{f((size_t)seq.get(i),acc_t);}
+		}
+
+		acc.template reduce<prp>(v_prp);
+
+		this->template markPropDirty<prp>();
+	}
+
 	/*! \brief Return from which cell we have to start in case of CRS interation
 	 *         scheme
 	 *
@@ -3037,6 +4598,7 @@ public:
 		template<unsigned int ... prp> void deviceToHostProp()
 		{
 			v_prp.template deviceToHost<prp ...>();
+			this->markAllPropDirty();
 		}
 
 		/*! \brief Move the memory from the device to host memory
@@ -3050,6 +4612,7 @@ public:
 		template<unsigned int ... prp> void deviceToHostProp(size_t start, size_t stop)
 		{
 			v_prp.template deviceToHost<prp ...>(start,stop);
+			this->markAllPropDirty();
 		}
 
 		/*! \brief Move the memory from the device to host memory
@@ -3060,6 +4623,7 @@ public:
 		void deviceToHostPos()
 		{
 			v_pos.template deviceToHost<0>();
+			this->incPosVersion();
 		}
 
 		/*! \brief Move the memory from the device to host memory
@@ -3085,6 +4649,7 @@ public:
 		void set_g_m(size_t g_m)
 		{
 			this->g_m = g_m;
+			this->incPosVersion();
 		}
 
         /*! \brief this function sort the vector
@@ -3106,6 +4671,10 @@ public:
                 // swap the sorted with the non-sorted
                 v_pos.swap(v_pos_out);
                 v_prp.swap(v_prp_out);
+
+                this->lazy_map_invalidate();
+                this->incIdxVersion();
+                this->incPosVersion();
         }
 
         /*! \brief this function sort the vector
@@ -3129,6 +4698,10 @@ public:
 			v_pos.swap(v_pos_out);
 			v_prp.swap(v_prp_out);
 
+			this->lazy_map_invalidate();
+			this->incIdxVersion();
+			this->incPosVersion();
+
 #endif
         }
 
@@ -19,6 +19,10 @@
 #include "cuda/vector_dist_comm_util_funcs.cuh"
 #include "util/cuda/scan_ofp.cuh"
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 template<typename T>
 struct DEBUG
 {
@@ -60,6 +64,94 @@ inline static size_t compute_options(size_t opt)
 	return opt_;
 }
 
+/*! \brief Type used to transfer a property with GHOST_REDUCED_PRECISION, double are sent as float
+ *
+ * \tparam T type of the property
+ *
+ */
+template<typename T>
+struct ghost_reduced_type
+{
+	//! transferred type
+	typedef T type;
+
+	/*! \brief Convert from/to the transferred type
+	 *
+	 * \param dst destination
+	 * \param src source
+	 *
+	 */
+	template<typename D, typename S> static inline void copy(D && dst, const S & src)
+	{
+		dst = src;
+	}
+};
+
+//! double are sent as float
+template<>
+struct ghost_reduced_type<double> : public ghost_reduced_type<float>
+{};
+
+//! arrays are converted element by element
+template<typename T, size_t N>
+struct ghost_reduced_type<T[N]>
+{
+	//! transferred type
+	typedef typename ghost_reduced_type<T>::type type[N];
+
+	/*! \brief Convert from/to the transferred type
+	 *
+	 * \param dst destination
+	 * \param src source
+	 *
+	 */
+	template<typename D, typename S> static inline void copy(D && dst, const S & src)
+	{
+		for (size_t i = 0 ; i < N ; i++)
+		{ghost_reduced_type<T>::copy(dst[i],src[i]);}
+	}
+};
+
+/*! \brief Copy the properties prp between a particle and its reduced precision representation
+ *
+ * \tparam to_red true convert to the reduced representation, false convert back
+ * \tparam prop properties of the particles
+ * \tparam v_mpl properties to copy
+ *
+ */
+template<bool to_red, typename prop, typename v_mpl, typename encap_prp, typename encap_red>
+struct ghost_reduced_copy
+{
+	//! particle properties
+	encap_prp prp;
+
+	//! reduced representation
+	encap_red red;
+
+	/*! \brief Constructor
+	 *
+	 * \param prp particle properties
+	 * \param red reduced representation
+	 *
+	 */
+	inline ghost_reduced_copy(encap_prp prp, encap_red red)
+	:prp(prp),red(red)
+	{}
+
+	//! It call the copy function for each property
+	template<typename T>
+	inline void operator()(T& t)
+	{
+		typedef typename boost::mpl::at<v_mpl,boost::mpl::int_<T::value>>::type prp_id;
+		typedef typename boost::mpl::at<typename prop::type,prp_id>::type prp_type;
+
+		if (to_red == true)
+		{ghost_reduced_type<prp_type>::copy(red.template get<T::value>(),prp.template get<prp_id::value>());}
+		else
+		{ghost_reduced_type<prp_type>::copy(prp.template get<prp_id::value>(),red.template get<T::value>());}
+	}
+};
+
 /*! \brief template selector for asynchronous or not asynchronous
  *
  * \tparam impl implementation
@@ -374,6 +466,99 @@ class vector_dist_comm
 	//! particles that must be communicated to the other processors
 	openfpm::vector<openfpm::vector<aggregate<size_t,size_t>>> g_opart;
 
+	//! Minimum number of particles to label with more threads
+	static const size_t label_omp_min = 4096;
+
+	//! Per thread m_opart (multi-threaded labelling)
+	openfpm::vector<openfpm::vector<aggregate<int,int,int>>> m_opart_thr;
+
+	//! Per thread g_opart (multi-threaded labelling)
+	openfpm::vector<openfpm::vector<openfpm::vector<aggregate<size_t,size_t>>>> g_opart_thr;
+
+	//! Per thread buffer for ghost_processorID_pair (multi-threaded labelling)
+	openfpm::vector<openfpm::vector<std::pair<size_t,size_t>>> ids_p_thr;
+
+	//! Cells of the last cell-list given to ghost_candidates_from_cells that intersect the internal ghost boxes
+	openfpm::vector<size_t> skin_cells;
+
+	//! Decomposition for which skin_cells has been computed (-1 invalid)
+	long int skin_ndec = -1;
+
+	//! Number of cells in each direction of the cell-list for which skin_cells has been computed
+	size_t skin_div[dim];
+
+	//! Cell size of the cell-list for which skin_cells has been computed
+	Point<dim,St> skin_spacing;
+
+	//! Cell of the processor bounding box origin for the cell-list used to compute skin_cells
+	grid_key_dx<dim> skin_orig;
+
+	//! Particles to label in the next ghost_get (see ghost_candidates_from_cells)
+	openfpm::vector<size_t> ghost_cand;
+
+	//! Indicate that the next ghost labelling must use only ghost_cand
+	bool ghost_cand_active = false;
+
+	//! Positions of the particles at the last lazy map (MAP_LAZY)
+	openfpm::vector<Point<dim,St>> lazy_pos;
+
+	//! Distance of the particles from the border of their sub-domain at the last lazy map
+	openfpm::vector<St> lazy_dist;
+
+	//! Indicate that lazy_pos and lazy_dist are valid
+	bool lazy_valid = false;
+
+	//! Decomposition from which lazy_dist is calculated
+	long int lazy_ndec = -1;
+
+	//! Bounding box of the local sub-domains used by the lazy map
+	Box<dim,St> lazy_bound;
+
+	//! For each cell of the processor bounding box the local sub-domains that intersect it
+	CellList<dim,St,Mem_fast<HeapMemory,int>,shift<dim,St>> lazy_cl;
+
+	//! Decomposition from which lazy_cl is calculated
+	long int lazy_cl_ndec = -1;
+
+	//! Version of the particle positions, it is incremented every time the positions can be changed
+	size_t v_pos_version = 0;
+
+	//! Version of the particle indexes, it is incremented every time the local particles can have been reordered
+	size_t v_idx_version = 0;
+
+	//! Version of the particle positions used by the last ghost labelling
+	size_t gg_lab_version = 0;
+
+	//! ghost marker at the last ghost labelling
+	size_t gg_lab_g_m = 0;
+
+	//! Decomposition used by the last ghost labelling
+	long int gg_lab_ndec = -1;
+
+	//! Indicate that the last ghost labelling has been done on all processors and not invalidated by a map
+	bool gg_lab_valid = false;
+
+	//! Indicate that the last ghost labelling received the positions
+	bool gg_lab_pos = false;
+
+	//! Indicate that the last ghost labelling received properties
+	bool gg_lab_prp = false;
+
+	//! Number of ghost labelling done, the ghost particles indexes change every time it is incremented
+	size_t gg_lab_epoch = 0;
+
+	//! Properties that can have been modified after the last ghost_get that sent them (one bit for each property)
+	size_t prp_dirty = (size_t)-1;
+
+	//! Properties that has been received in the ghost with the current labelling (one bit for each property)
+	size_t prp_ghost_valid = 0;
+
+	//! Indicate that the positions can have been changed after the last ghost_get (folded in v_pos_version)
+	bool pos_changed = false;
+
+	//! For each property indicate that it can have been changed after the last ghost_get (folded in prp_dirty)
+	bool prp_changed[64] = {};
+
 	//! Same as g_opart but on device, the vector of vector is flatten into a single vector
     openfpm::vector<aggregate<unsigned int,unsigned long int>,
                     CudaMemory,
@@ -402,6 +587,12 @@ class vector_dist_comm
 	//! the same as prc_recv_get but for map
 	openfpm::vector<size_t> prc_recv_map;
 
+	//! the same as prc_recv_map but for the properties of an asynchronous map
+	openfpm::vector<size_t> prc_recv_map_prp;
+
+	//! processors to which we send particles in the last asynchronous map
+	openfpm::vector<size_t> prc_send_map;
+
 	//! It store the size of the elements added for each processor that communicate with us (local processor)
 	//! from the last ghost get
 	openfpm::vector<size_t> recv_sz_get_pos;
@@ -416,6 +607,9 @@ class vector_dist_comm
 	//! The same as recv_sz_get but for map
 	openfpm::vector<size_t> recv_sz_map;
 
+	//! The same as recv_sz_map but for the properties of an asynchronous map
+	openfpm::vector<size_t> recv_sz_map_prp;
+
 	//! elements sent for each processors (ghost_get)
 	openfpm::vector<size_t> prc_sz_gg;
 
@@ -443,6 +637,33 @@ class vector_dist_comm
 	//! Sending buffer
 	openfpm::vector_fr<Memory> hsmem;
 
+	//! Sending buffers retained across map calls (position and properties for each processor)
+	openfpm::vector_fr<Memory> hsmem_map;
+
+	//! Sending buffers of the Ighost_put in flight (separated from hsmem used by ghost_get)
+	openfpm::vector_fr<Memory> hsmem_put;
+
+	//! Receiving buffer retained across the ghost_get with GHOST_REDUCED_PRECISION
+	openfpm::vector_fr<Memory> hrmem_red;
+
+	//! Ghost labelling used by the merge of the Ighost_put in flight (copy of g_opart at Ighost_put time)
+	openfpm::vector<openfpm::vector<aggregate<size_t,size_t>>> gp_opart;
+
+	//! Copy of prc_g_opart at Ighost_put time
+	openfpm::vector<size_t> gp_prc_g_opart;
+
+	//! Copy of g_opart_sz at Ighost_put time
+	openfpm::vector<size_t> gp_opart_sz;
+
+	//! Copy of the processors from which the last ghost_get received at Ighost_put time
+	openfpm::vector<size_t> gp_prc_recv;
+
+	//! Indicate that an Ighost_put has been started and ghost_put_wait has not been called yet
+	bool gp_in_flight = false;
+
+	//! Contiguous sending arena for map (used with MAP_SEND_ARENA)
+	Memory map_arena_mem;
+
 	//! process the particle with properties
 	template<typename prp_object, int ... prp>
 	struct proc_with_prp
@@ -956,13 +1177,15 @@ class vector_dist_comm
 	 * \param v_prp vector of particle properties
 	 * \param g_send_prp Send buffer to fill
 	 * \param g_m ghost marker
+	 * \param pool retained buffers used for the send buffers
 	 *
 	 */
 	template<typename send_vector, typename prp_object, int ... prp>
 	void fill_send_ghost_put_prp_buf(openfpm::vector<prop,Memory,layout_base> & v_prp,
 									 openfpm::vector<send_vector> & g_send_prp,
 									 size_t & g_m,
-									 size_t opt)
+									 size_t opt,
+									 openfpm::vector_fr<Memory> & pool)
 	{
 		// create a number of send buffers equal to the near processors
 		// from which we received
@@ -973,17 +1196,17 @@ class vector_dist_comm
 
 		g_send_prp.resize(nproc);
 
-		resize_retained_buffer(hsmem,g_send_prp.size());
+		resize_retained_buffer(pool,g_send_prp.size());
 
 		for (size_t i = 0; i < g_send_prp.size(); i++)
 		{
 			// Buffer must retained and survive the destruction of the
 			// vector
-			if (hsmem.get(i).ref() == 0)
-				hsmem.get(i).incRef();
+			if (pool.get(i).ref() == 0)
+				pool.get(i).incRef();
 
 			// Set the memory for retain the send buffer
-			g_send_prp.get(i).setMemory(hsmem.get(i));
+			g_send_prp.get(i).setMemory(pool.get(i));
 
 			size_t n_part_recv = get_last_ghost_get_received_parts(i);
 
@@ -1061,7 +1284,7 @@ class vector_dist_comm
 			rt_buf.get(i).decRef();
 		}
 
-		hsmem.resize(nbf);
+		rt_buf.resize(nbf);
 	}
 
 	/*! \brief Set the buffer for each property
@@ -1228,6 +1451,54 @@ class vector_dist_comm
 		}
 	}
 
+	/*! \brief Set the sending buffers of map on the retained memory
+	 *
+	 * The buffers survive across map calls, and they are only enlarged when a message
+	 * does not fit anymore. In steady state no allocation is produced
+	 *
+	 * \param m_pos sending buffer for position
+	 * \param m_prp sending buffer for properties
+	 * \param prc_sz_r For each processor in the list the number of particles to send
+	 *
+	 */
+	template<typename send_pos_type, typename send_prp_type>
+	void set_map_retained_buffers(openfpm::vector<send_pos_type> & m_pos,
+								  openfpm::vector<send_prp_type> & m_prp,
+								  openfpm::vector<size_t> & prc_sz_r)
+	{
+		typedef boost::mpl::range_c<int,0,prop::max_prop> v_mpl;
+
+		// one buffer for the position plus the buffers for the properties
+		size_t factor = 1;
+		if (is_layout_inte<layout_base<prop>>::value == true) {factor += prop::max_prop;}
+		else {factor += 1;}
+
+		// The pool only grow
+		if (hsmem_map.size() < prc_sz_r.size()*factor)
+		{resize_retained_buffer(hsmem_map,prc_sz_r.size()*factor);}
+
+		for (size_t i = 0; i < hsmem_map.size(); i++)
+		{
+			// Buffer must retained and survive the destruction of the
+			// vector
+			if (hsmem_map.get(i).ref() == 0)
+			{hsmem_map.get(i).incRef();}
+		}
+
+		size_t j = 0;
+		for (size_t i = 0; i < prc_sz_r.size() ; i++)
+		{
+			// Set the memory for retain the send buffer
+			m_pos.get(i).setMemory(hsmem_map.get(j));
+
+			// resize the sending vector (No allocation is produced)
+			m_pos.get(i).resize(prc_sz_r.get(i));
+			j++;
+
+			j = set_mem_retained_buffers<is_layout_inte<layout_base<prop>>::value,send_prp_type,v_mpl>::set_mem_retained_buffers_(m_prp,prc_sz_r,i,hsmem_map,j);
+		}
+	}
+
 	/*! \brief allocate and fill the send buffer for the map function
 	 *
 	 * \param v_pos vector of particle positions
@@ -1252,13 +1523,11 @@ class vector_dist_comm
 		m_pos.resize(prc_sz_r.size());
 		openfpm::vector<size_t> cnt(prc_sz_r.size());
 
+		// set the size on the retained buffers
+		set_map_retained_buffers(m_pos,m_prp,prc_sz_r);
+
 		for (size_t i = 0; i < prc_sz_r.size() ; i++)
-		{
-			// set the size and allocate, using mem warant that pos and prp is contiguous
-			m_pos.get(i).resize(prc_sz_r.get(i));
-			m_prp.get(i).resize(prc_sz_r.get(i));
-			cnt.get(i) = 0;
-		}
+		{cnt.get(i) = 0;}
 
 		if (opt & RUN_ON_DEVICE)
 		{
@@ -1377,6 +1646,77 @@ class vector_dist_comm
 	}
 
 
+	/*! \brief Size in byte of a block in the map sending arena (aligned to the cache line)
+	 *
+	 * \param sz size in byte
+	 *
+	 * \return the size aligned
+	 *
+	 */
+	static size_t map_arena_align(size_t sz)
+	{
+		return (sz + 63) / 64 * 64;
+	}
+
+	/*! \brief fill the send buffer for the map function packing all the messages into
+	 *         one contiguous arena
+	 *
+	 * For each processor the positions and the properties are packed one after the other into
+	 * a single contiguous block of the arena. The arena is retained across map calls
+	 *
+	 * \param v_pos vector of particle positions
+	 * \param v_prp vector of particles properties
+	 * \param prc_sz_r For each processor in the list the number of particles to send
+	 * \param m_pos sending buffer for position
+	 * \param m_prp sending buffer for properties
+	 * \param prAlloc arena
+	 *
+	 */
+	template<typename send_pos_type, typename send_prp_type>
+	void fill_send_map_buf_arena(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
+			                     openfpm::vector<prop,Memory,layout_base> & v_prp,
+			                     openfpm::vector<size_t> & prc_sz_r,
+			                     openfpm::vector<send_pos_type> & m_pos,
+			                     openfpm::vector<send_prp_type> & m_prp,
+			                     ExtPreAlloc<Memory> & prAlloc)
+	{
+		m_prp.resize(prc_sz_r.size());
+		m_pos.resize(prc_sz_r.size());
+		openfpm::vector<size_t> cnt(prc_sz_r.size());
+
+		for (size_t i = 0; i < prc_sz_r.size() ; i++)
+		{
+			size_t sz_pos = prc_sz_r.get(i)*sizeof(Point<dim,St>);
+			size_t sz_prp = prc_sz_r.get(i)*sizeof(prop);
+
+			// position and properties for the processor i are contiguous
+			m_pos.get(i).setMemory(prAlloc);
+			m_pos.get(i).resize(prc_sz_r.get(i));
+			prAlloc.allocate(map_arena_align(sz_pos) - sz_pos);
+
+			m_prp.get(i).setMemory(prAlloc);
+			m_prp.get(i).resize(prc_sz_r.get(i));
+			prAlloc.allocate(map_arena_align(sz_prp) - sz_prp);
+
+			cnt.get(i) = 0;
+		}
+
+		// end vector point
+		long int id_end = v_pos.size();
+
+		// end opart point
+		long int end = m_opart.size()-1;
+
+		// Run through all the particles and fill the sending buffer
+		for (size_t i = 0; i < m_opart.size(); i++)
+		{
+			process_map_particle<proc_without_prp>(i,end,id_end,m_opart,p_map_req,m_pos,m_prp,v_pos,v_prp,cnt);
+		}
+
+		v_pos.resize(v_pos.size() - m_opart.size());
+		v_prp.resize(v_prp.size() - m_opart.size());
+	}
+
 	/*! \brief allocate and fill the send buffer for the map function
 	 *
 	 * \tparam prp_object object type to send
@@ -1424,6 +1764,173 @@ class vector_dist_comm
 		v_prp.resize(v_prp.size() - m_opart.size());
 	}
 
+#ifdef _OPENMP
+
+	/*! \brief Label particles for mappings using all the threads
+	 *
+	 * Every thread label a contiguous chunk of particles into its own bucket, the buckets are
+	 * then merged in thread order, so the result is the same of the serial labelling
+	 *
+	 * \param v_pos vector of particle positions
+	 * \param lbl_p Particle labeled
+	 * \param prc_sz For each processor the number of particles to send
+	 *
+	 */
+	template<typename obp> void labelParticleProcessor_omp(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
+			                                               openfpm::vector<aggregate<int,int,int>,
+			                                                               Memory,
+			                                                               layout_base> & lbl_p,
+			                                               openfpm::vector<aggregate<unsigned int,unsigned int>,Memory,layout_base> & prc_sz)
+	{
+		size_t n_thr = omp_get_max_threads();
+		size_t rank = v_cl.getProcessUnitID();
+
+		m_opart_thr.resize(n_thr);
+		for (size_t t = 0 ; t < n_thr ; t++)
+		{m_opart_thr.get(t).clear();}
+
+		#pragma omp parallel num_threads(n_thr)
+		{
+			size_t t = omp_get_thread_num();
+			size_t nt = omp_get_num_threads();
+
+			size_t start = v_pos.size() * t / nt;
+			size_t stop = v_pos.size() * (t+1) / nt;
+
+			auto & lbl_t = m_opart_thr.get(t);
+
+			for (size_t key = start ; key < stop ; key++)
+			{
+				// Apply the boundary conditions
+				dec.applyPointBC(v_pos.get(key));
+
+				long int p_id = 0;
+
+				// Check if the particle is inside the domain
+				if (dec.getDomain().isInside(v_pos.get(key)) == true)
+				{p_id = dec.processorID(v_pos.get(key));}
+				else
+				{p_id = obp::out(key, rank);}
+
+				// Particle to move
+				if (p_id != (long int)rank)
+				{
+					lbl_t.add();
+					lbl_t.last().template get<0>() = key;
+					lbl_t.last().template get<2>() = p_id;
+				}
+			}
+		}
+
+		// prefix sum of the bucket sizes
+		openfpm::vector<size_t> off(n_thr+1);
+		off.get(0) = 0;
+		for (size_t t = 0 ; t < n_thr ; t++)
+		{off.get(t+1) = off.get(t) + m_opart_thr.get(t).size();}
+
+		lbl_p.resize(off.get(n_thr));
+
+		#pragma omp parallel for num_threads(n_thr)
+		for (size_t t = 0 ; t < n_thr ; t++)
+		{
+			auto & lbl_t = m_opart_thr.get(t);
+
+			for (size_t i = 0 ; i < lbl_t.size() ; i++)
+			{
+				lbl_p.template get<0>(off.get(t) + i) = lbl_t.template get<0>(i);
+				lbl_p.template get<2>(off.get(t) + i) = lbl_t.template get<2>(i);
+			}
+		}
+
+		// count the particles to send to each processor
+		for (size_t i = 0 ; i < lbl_p.size() ; i++)
+		{
+			long int p_id = lbl_p.template get<2>(i);
+
+			if (p_id != -1)
+			{prc_sz.template get<0>(p_id)++;}
+		}
+	}
+
+	/*! \brief Label the ghost particles using all the threads
+	 *
+	 * Every thread label a contiguous chunk of particles into its own per-processor buckets, the
+	 * buckets are then concatenated in thread order, so g_opart is the same of the serial labelling
+	 *
+	 * \param v_pos vector of particle positions
+	 * \param g_m ghost marker
+	 *
+	 */
+	void labelParticlesGhost_omp(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
+								 size_t g_m)
+	{
+		size_t n_thr = omp_get_max_threads();
+		size_t n_nn = dec.getNNProcessors();
+
+		g_opart_thr.resize(n_thr);
+		ids_p_thr.resize(n_thr);
+		for (size_t t = 0 ; t < n_thr ; t++)
+		{
+			g_opart_thr.get(t).resize(n_nn);
+
+			for (size_t i = 0 ; i < n_nn ; i++)
+			{g_opart_thr.get(t).get(i).clear();}
+		}
+
+		#pragma omp parallel num_threads(n_thr)
+		{
+			size_t t = omp_get_thread_num();
+			size_t nt = omp_get_num_threads();
+
+			size_t start = g_m * t / nt;
+			size_t stop = g_m * (t+1) / nt;
+
+			auto & g_opart_t = g_opart_thr.get(t);
+			auto & vp_id = ids_p_thr.get(t);
+
+			for (size_t key = start ; key < stop ; key++)
+			{
+				dec.template ghost_processorID_pair<typename Decomposition::lc_processor_id, typename Decomposition::shift_id>(v_pos.get(key),vp_id,UNIQUE);
+
+				for (size_t i = 0; i < vp_id.size(); i++)
+				{
+					size_t p_id = vp_id.get(i).first;
+
+					g_opart_t.get(p_id).add();
+					g_opart_t.get(p_id).last().template get<0>() = key;
+					g_opart_t.get(p_id).last().template get<1>() = vp_id.get(i).second;
+				}
+			}
+		}
+
+		// merge the buckets of each processor
+		#pragma omp parallel for num_threads(n_thr)
+		for (size_t i = 0 ; i < n_nn ; i++)
+		{
+			size_t sz = 0;
+			for (size_t t = 0 ; t < n_thr ; t++)
+			{sz += g_opart_thr.get(t).get(i).size();}
+
+			auto & g_o = g_opart.get(i);
+			g_o.resize(sz);
+
+			size_t k = 0;
+			for (size_t t = 0 ; t < n_thr ; t++)
+			{
+				auto & g_t = g_opart_thr.get(t).get(i);
+
+				for (size_t j = 0 ; j < g_t.size() ; j++)
+				{
+					g_o.template get<0>(k) = g_t.template get<0>(j);
+					g_o.template get<1>(k) = g_t.template get<1>(j);
+					k++;
+				}
+			}
+		}
+	}
+
+#endif
+
 	/*! \brief Label particles for mappings
 	 *
 	 * \param v_pos vector of particle positions
@@ -1538,6 +2045,14 @@ class vector_dist_comm
 			// resize the label buffer
 			prc_sz.template fill<0>(0);
 
+#ifdef _OPENMP
+			if (omp_get_max_threads() > 1 && v_pos.size() >= label_omp_min)
+			{
+				labelParticleProcessor_omp<obp>(v_pos,lbl_p,prc_sz);
+				return;
+			}
+#endif
+
 			auto it = v_pos.getIterator();
 
 			// Label all the particles with the processor id where they should go
@@ -1581,6 +2096,30 @@ class vector_dist_comm
 		}
 	}
 
+	/*! \brief Label one particle for ghost_get
+	 *
+	 * \param v_pos vector of particle positions
+	 * \param key particle to label
+	 *
+	 */
+	inline void labelParticleGhost(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos, size_t key)
+	{
+		// Given a particle, it return which processor require it (first id) and shift id, second id
+		// For an explanation about shifts vectors please consult getShiftVector in ie_ghost
+		const openfpm::vector<std::pair<size_t, size_t>> & vp_id = dec.template ghost_processorID_pair<typename Decomposition::lc_processor_id, typename Decomposition::shift_id>(v_pos.get(key), UNIQUE);
+
+		for (size_t i = 0; i < vp_id.size(); i++)
+		{
+			// processor id
+			size_t p_id = vp_id.get(i).first;
+
+			// add particle to communicate
+			g_opart.get(p_id).add();
+			g_opart.get(p_id).last().template get<0>() = key;
+			g_opart.get(p_id).last().template get<1>() = vp_id.get(i).second;
+		}
+	}
+
 	/*! \brief Label the particles
 	 *
 	 * It count the number of particle to send to each processors and save its ids
@@ -1616,28 +2155,28 @@ class vector_dist_comm
 		}
 		else
 		{
-			// Iterate over all particles
-			auto it = v_pos.getIteratorTo(g_m);
-			while (it.isNext())
+			if (ghost_cand_active == true)
 			{
-				auto key = it.get();
+				// Only the particles in the skin cells can be ghost
+				for (size_t j = 0 ; j < ghost_cand.size() ; j++)
+				{labelParticleGhost(v_pos,ghost_cand.get(j));}
 
-				// Given a particle, it return which processor require it (first id) and shift id, second id
-				// For an explanation about shifts vectors please consult getShiftVector in ie_ghost
-				const openfpm::vector<std::pair<size_t, size_t>> & vp_id = dec.template ghost_processorID_pair<typename Decomposition::lc_processor_id, typename Decomposition::shift_id>(v_pos.get(key), UNIQUE);
-
-				for (size_t i = 0; i < vp_id.size(); i++)
+				ghost_cand_active = false;
+			}
+#ifdef _OPENMP
+			else if (omp_get_max_threads() > 1 && g_m >= label_omp_min)
+			{labelParticlesGhost_omp(v_pos,g_m);}
+#endif
+			else
+			{
+				// Iterate over all particles
+				auto it = v_pos.getIteratorTo(g_m);
+				while (it.isNext())
 				{
-					// processor id
-					size_t p_id = vp_id.get(i).first;
+					labelParticleGhost(v_pos,it.get());
 
-					// add particle to communicate
-					g_opart.get(p_id).add();
-					g_opart.get(p_id).last().template get<0>() = key;
-					g_opart.get(p_id).last().template get<1>() = vp_id.get(i).second;
+					++it;
 				}
-
-				++it;
 			}
 
 			// remove all zero entry and construct prc (the list of the sending processors)
@@ -1662,6 +2201,62 @@ class vector_dist_comm
 #endif
 	}
 
+	/*! \brief Send the particles labelled for migration packing them into the contiguous map arena
+	 *
+	 * \param v_pos vector of particle positions
+	 * \param v_prp vector of particle properties
+	 * \param prc_sz_r For each processor in the list the number of particles to send
+	 * \param prc_r list of processors to send to
+	 *
+	 */
+	void map_arena_(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
+					openfpm::vector<prop,Memory,layout_base> & v_prp,
+					openfpm::vector<size_t> & prc_sz_r,
+					openfpm::vector<size_t> & prc_r)
+	{
+		typedef openfpm::vector<Point<dim,St>,ExtPreAlloc<Memory>,layout_base,openfpm::grow_policy_identity> send_pos_arena;
+		typedef openfpm::vector<prop,ExtPreAlloc<Memory>,layout_base,openfpm::grow_policy_identity> send_prp_arena;
+
+		// Calculate the size of the arena
+		size_t req = 0;
+		for (size_t i = 0 ; i < prc_sz_r.size() ; i++)
+		{
+			req += map_arena_align(prc_sz_r.get(i)*sizeof(Point<dim,St>));
+			req += map_arena_align(prc_sz_r.get(i)*sizeof(prop));
+		}
+
+		// The arena memory is retained, it is enlarged only if needed
+		if (map_arena_mem.size() < req)
+		{map_arena_mem.resize(req);}
+
+		// Create an object of preallocated memory for the arena
+		ExtPreAlloc<Memory> & prAlloc = *(new ExtPreAlloc<Memory>(map_arena_mem.size(),map_arena_mem));
+		// The sending buffers must not destroy the arena when they go out of scope
+		prAlloc.incRef();
+
+		{
+			//! position vector
+			openfpm::vector<send_pos_arena> m_pos;
+			//! properties vector
+			openfpm::vector<send_prp_arena> m_prp;
+
+			fill_send_map_buf_arena(v_pos,v_prp,prc_sz_r,m_pos,m_prp,prAlloc);
+
+			v_cl.template SSendRecv<send_pos_arena,
+						   openfpm::vector<Point<dim, St>,Memory,layout_base>,
+						   layout_base>
+						   (m_pos,v_pos,prc_r,prc_recv_map,recv_sz_map,0);
+
+			v_cl.template SSendRecv<send_prp_arena,
+						   openfpm::vector<prop,Memory,layout_base>,
+						   layout_base>
+						   (m_prp,v_prp,prc_r,prc_recv_map,recv_sz_map,0);
+		}
+
+		prAlloc.decRef();
+		delete &prAlloc;
+	}
+
 	/*! \brief Call-back to allocate buffer to receive incoming elements (particles)
 	 *
 	 * \param msg_i size required to receive the message from i
@@ -1745,6 +2340,29 @@ public:
 				std::cout << __FILE__ << ":" << __LINE__ << " internal error memory is in an invalid state " << std::endl;
 		}
 
+		for (size_t i = 0 ; i < hsmem_map.size() ; i++)
+		{
+			if (hsmem_map.get(i).ref() == 1)
+				hsmem_map.get(i).decRef();
+			else
+				std::cout << __FILE__ << ":" << __LINE__ << " internal error memory is in an invalid state " << std::endl;
+		}
+
+		for (size_t i = 0 ; i < hsmem_put.size() ; i++)
+		{
+			if (hsmem_put.get(i).ref() == 1)
+				hsmem_put.get(i).decRef();
+			else
+				std::cout << __FILE__ << ":" << __LINE__ << " internal error memory is in an invalid state " << std::endl;
+		}
+
+		for (size_t i = 0 ; i < hrmem_red.size() ; i++)
+		{
+			if (hrmem_red.get(i).ref() == 1)
+				hrmem_red.get(i).decRef();
+			else
+				std::cout << __FILE__ << ":" << __LINE__ << " internal error memory is in an invalid state " << std::endl;
+		}
 	}
 
 	/*! \brief Get the number of minimum sub-domain per processor
@@ -1832,166 +2450,601 @@ public:
 		dec.decompose();
 	}
 
-	/*! \brief It synchronize the properties and position of the ghost particles
+	/*! \brief Invalidate the information used by the lazy map (MAP_LAZY)
 	 *
-	 * \tparam prp list of properties to get synchronize
+	 * It must be called every time the order of the particles change without a map
 	 *
-	 * \param opt options WITH_POSITION, it send also the positional information of the particles
-	 * \param v_pos vector of position to update
-	 * \param v_prp vector of properties to update
-	 * \param g_m marker between real and ghost particles
+	 */
+	void lazy_map_invalidate()
+	{
+		lazy_valid = false;
+	}
+
+	/*! \brief Signal that the local particles can have been reordered without a map
+	 *
+	 * The structures that store particle indexes (incremental cell-list, managed Verlet list, ...) are
+	 * reconstructed when the version change
 	 *
 	 */
-	template<unsigned int impl, int ... prp> inline void ghost_get_(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
-												 openfpm::vector<prop,Memory,layout_base> & v_prp,
-												 size_t & g_m,
-												 size_t opt = WITH_POSITION)
+	inline void incIdxVersion()
 	{
-#ifdef PROFILE_SCOREP
-		SCOREP_USER_REGION("ghost_get",SCOREP_USER_REGION_TYPE_FUNCTION)
-#endif
+		v_idx_version++;
+	}
 
-		// Sending property object
-		typedef object<typename object_creator<typename prop::type, prp...>::type> prp_object;
+	/*! \brief Get the number of ghost labelling done
+	 *
+	 * If it does not change the ghost particles keep the same indexes
+	 *
+	 * \return the number of ghost labelling
+	 *
+	 */
+	inline size_t getGhostLabellingEpoch() const
+	{
+		return gg_lab_epoch;
+	}
 
-		// send vector for each processor
-		typedef openfpm::vector<prp_object,Memory,layout_base,openfpm::grow_policy_identity> send_vector;
+	/*! \brief Get the version of the particle indexes
+	 *
+	 * It change every time the local particles can have been reordered (map, reorder, remove ...)
+	 *
+	 * \return the version of the indexes
+	 *
+	 */
+	inline size_t getIdxVersion() const
+	{
+		return v_idx_version;
+	}
 
-		if (!(opt & NO_POSITION))
-		{v_pos.resize(g_m);}
+	/*! \brief Signal that the positions of the local particles can have been changed
+	 *
+	 * The labelling of the last ghost_get is reused (GHOST_AUTO_REUSE) only if the positions did not change.
+	 * It is called by the explicit write paths, that can run inside threaded loops, so it only set a flag
+	 * (every thread write the same value) that is folded in the version by the next ghost_get
+	 *
+	 */
+	inline void incPosVersion()
+	{
+		if (pos_changed == false)
+		{pos_changed = true;}
+	}
 
-		// reset the ghost part
+	/*! \brief Check if an Ighost_put has been started and ghost_put_wait has not been called yet
+	 *
+	 * \return true if the ghost_put is in flight
+	 *
+	 */
+	inline bool isGhostPutInFlight() const
+	{
+		return gp_in_flight;
+	}
 
-		if (!(opt & SKIP_LABELLING))
-		{v_prp.resize(g_m);}
+	/*! \brief Get the version of the particle positions
+	 *
+	 * \return the version of the positions
+	 *
+	 */
+	inline size_t getPosVersion() const
+	{
+		return v_pos_version + ((pos_changed == true)?1:0);
+	}
 
-		// Label all the particles
-		if ((opt & SKIP_LABELLING) == false)
-		{labelParticlesGhost(v_pos,v_prp,prc_g_opart,prc_sz_gg,prc_offset,g_m,opt);}
+	/*! \brief Fold the changes signalled by incPosVersion and markPropDirty in the versions
+	 *
+	 * It must be called outside threaded regions, before the versions are used
+	 *
+	 */
+	void fold_changes()
+	{
+		if (pos_changed == true)
+		{
+			v_pos_version++;
+			pos_changed = false;
+		}
 
+		for (size_t i = 0 ; i < 64 ; i++)
 		{
-			// Send and receive ghost particle information
-			openfpm::vector<send_vector> g_send_prp;
+			if (prp_changed[i] == true)
+			{
+				prp_dirty |= prp_bit(i);
+				prp_changed[i] = false;
+			}
+		}
+	}
 
-			fill_send_ghost_prp_buf<send_vector, prp_object, prp...>(v_prp,prc_sz_gg,g_send_prp,opt);
+	/*! \brief Invalidate the labelling of the last ghost_get on all processors
+	 *
+	 * It is called by the collective operations that move the particles (map and similar)
+	 *
+	 */
+	void ghost_labelling_invalidate()
+	{
+		fold_changes();
 
-	#if defined(CUDA_GPU) && defined(__NVCC__)
-			cudaDeviceSynchronize();
-	#endif
+		v_pos_version++;
+		v_idx_version++;
+		gg_lab_valid = false;
+		prp_ghost_valid = 0;
 
-			// if there are no properties skip
-			// SSendRecvP send everything when we do not give properties
+		ghost_candidates_clear();
+	}
 
-			ghost_exchange_comm_impl<impl,layout_base,prp ...>::template
-			sendrecv_prp(v_cl,g_send_prp,v_prp,v_pos,prc_g_opart,
-					 prc_recv_get_prp,recv_sz_get_prp,recv_sz_get_byte,g_opart_sz,g_m,opt);
-		}
+	/*! \brief Forget the particles selected by ghost_candidates_from_cells
+	 *
+	 * The candidates are valid only for the next labelling of the particles they have been computed from
+	 *
+	 */
+	void ghost_candidates_clear()
+	{
+		ghost_cand_active = false;
+		ghost_cand.clear();
+	}
 
-		if (!(opt & NO_POSITION))
-		{
-			// Sending buffer for the ghost particles position
-			openfpm::vector<send_pos_vector> g_pos_send;
+	/*! \brief Bit used to track the property id
+	 *
+	 * Properties with id bigger than 62 share the last bit, that is never considered clean
+	 *
+	 * \param id property id
+	 *
+	 * \return the bit
+	 *
+	 */
+	static inline size_t prp_bit(unsigned int id)
+	{
+		return (size_t)1 << ((id < 63)?id:63);
+	}
 
-			fill_send_ghost_pos_buf(v_pos,prc_sz_gg,g_pos_send,opt,impl == GHOST_ASYNC);
+	/*! \brief Mask of the properties prp
+	 *
+	 * \tparam prp properties
+	 *
+	 * \return the mask
+	 *
+	 */
+	template<int ... prp> static inline size_t prp_mask()
+	{
+		size_t mask = 0;
 
-#if defined(CUDA_GPU) && defined(__NVCC__)
-			cudaDeviceSynchronize();
-#endif
+		int dummy[] = {0, (mask |= prp_bit(prp),0)...};
+		(void)dummy;
 
-			ghost_exchange_comm_impl<impl,layout_base,prp ...>::template
-			sendrecv_pos(v_cl,g_pos_send,v_prp,v_pos,prc_recv_get_pos,recv_sz_get_pos,prc_g_opart,opt);
+		return mask;
+	}
 
-            // fill g_opart_sz
-            g_opart_sz.resize(prc_g_opart.size());
+	/*! \brief Check if the ghost particles received the property id after the last ghost labelling
+	 *
+	 * \tparam id property
+	 *
+	 * \return true if the property id of the ghost particles is valid
+	 *
+	 */
+	template<unsigned int id> inline bool isGhostPropValid() const
+	{
+		return (prp_ghost_valid & prp_bit(id)) != 0;
+	}
 
-			for (size_t i = 0 ; i < prc_g_opart.size() ; i++)
-				g_opart_sz.get(i) = g_pos_send.get(i).size();
-		}
+	/*! \brief Signal that the property id of the local particles can have been changed
+	 *
+	 * It is called by the explicit write paths, that can run inside threaded loops, so it only set the
+	 * flag of the property that is folded in prp_dirty by the next ghost_get
+	 *
+	 * \tparam id property
+	 *
+	 */
+	template<unsigned int id> inline void markPropDirty()
+	{
+		const unsigned int i = (id < 63)?id:63;
 
-        // Important to ensure that the number of particles in v_prp must be equal to v_pos
-        // Note that if we do not give properties sizeof...(prp) == 0 in general at this point
-        // v_prp.size() != v_pos.size()
-        if (!(opt & SKIP_LABELLING))
-        {
-                v_prp.resize(v_pos.size());
-        }
+		if (prp_changed[i] == false)
+		{prp_changed[i] = true;}
+	}
 
-		add_loc_particles_bc(v_pos,v_prp,g_m,opt);
+	/*! \brief Signal that all the properties of the local particles can have been changed
+	 *
+	 */
+	inline void markAllPropDirty()
+	{
+		prp_dirty = (size_t)-1;
 	}
 
-	/*! \brief It synchronize the properties and position of the ghost particles
+	/*! \brief Check how much of the last ghost_get can be reused
 	 *
-	 * \tparam prp list of properties to get synchronize
+	 * The labelling can be reused if no processor changed the positions of its particles, the ghost marker, or the
+	 * decomposition, and the last labelling received the information requested now. If in addition the requested
+	 * properties have been received with this labelling and nobody modified them, the ghost is already up to date.
+	 * The answer is the same on all processors and it cost one reduction
 	 *
-	 * \param opt options WITH_POSITION, it send also the positional information of the particles
-	 * \param v_pos vector of position to update
-	 * \param v_prp vector of properties to update
-	 * \param g_m marker between real and ghost particles
+	 * \param g_m ghost marker
+	 * \param req_prp mask of the properties requested by the ghost_get
+	 * \param with_prp the ghost_get exchange properties
+	 * \param opt ghost_get options
+	 *
+	 * \return GHOST_REUSE_NONE, GHOST_REUSE_LABELLING (SKIP_LABELLING can be used) or GHOST_REUSE_ALL (nothing to send)
 	 *
 	 */
-	template<int ... prp> inline void ghost_wait_(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
-			 	 	 	 	 	 	 	 	 	 	 	 	 	 	 openfpm::vector<prop,Memory,layout_base> & v_prp,
-			 	 	 	 	 	 	 	 	 	 	 	 	 	 	 size_t & g_m,
-			 	 	 	 	 	 	 	 	 	 	 	 	 	 	 size_t opt = WITH_POSITION)
+	size_t ghost_reuse_check(size_t g_m, size_t req_prp, bool with_prp, size_t opt)
 	{
-		// Sending property object
-		typedef object<typename object_creator<typename prop::type, prp...>::type> prp_object;
+		// invalidated on all processors, no need to ask
+		if (gg_lab_valid == false)
+		{return GHOST_REUSE_NONE;}
 
-		// send vector for each processor
-		typedef openfpm::vector<prp_object,Memory,layout_base,openfpm::grow_policy_identity> send_vector;
+		size_t reuse = GHOST_REUSE_NONE;
 
-		// Send and receive ghost particle information
-		openfpm::vector<send_vector> g_send_prp;
-		openfpm::vector<send_pos_vector> g_pos_send;
+		if (gg_lab_version == v_pos_version &&
+		    gg_lab_g_m == g_m &&
+		    gg_lab_ndec == (long int)dec.get_ndec() &&
+		    (gg_lab_pos == true || (opt & NO_POSITION)) &&
+		    (gg_lab_prp == true || with_prp == false))
+		{
+			reuse = GHOST_REUSE_LABELLING;
 
-		ghost_exchange_comm_impl<GHOST_ASYNC,layout_base,prp ...>::template
-		sendrecv_prp_wait(v_cl,g_send_prp,v_prp,v_pos,prc_g_opart,
-					 prc_recv_get_prp,recv_sz_get_prp,recv_sz_get_byte,g_opart_sz,g_m,opt);
+			if ((req_prp & (prp_dirty | ~prp_ghost_valid)) == 0)
+			{reuse = GHOST_REUSE_ALL;}
+		}
 
+		v_cl.min(reuse);
+		v_cl.execute();
 
-		ghost_exchange_comm_impl<GHOST_ASYNC,layout_base,prp ...>::template
-		sendrecv_pos_wait(v_cl,g_pos_send,v_prp,v_pos,prc_recv_get_pos,recv_sz_get_pos,prc_g_opart,opt);
+		return reuse;
 	}
 
-	/*! \brief It move all the particles that does not belong to the local processor to the respective processor
+	/*! \brief Restrict the labelling of the next ghost_get to the particles in the skin cells of a cell-list
 	 *
-	 * \tparam out of bound policy it specify what to do when the particles are detected out of bound
-	 *
-	 * In general this function is called after moving the particles to move the
-	 * elements out the local processor. Or just after initialization if each processor
-	 * contain non local particles
-	 *
-	 * \tparam prp properties to communicate
+	 * Only the particles in the cells that intersect the internal ghost boxes can be ghost of a near
+	 * processor. The cell-list must be constructed on the actual particle positions (after the last map), the
+	 * labelling produced is the same of the full labelling. The skin cells are computed again only when the
+	 * decomposition or the geometry of the cell-list change
 	 *
 	 * \param v_pos vector of particle positions
-	 * \param v_prp vector of particle properties
 	 * \param g_m ghost marker
-	 * \param opt options
+	 * \param cl Cell-list
 	 *
 	 */
-	template<unsigned int ... prp> void map_list_(openfpm::vector<Point<dim, St>> & v_pos, openfpm::vector<prop> & v_prp, size_t & g_m, size_t opt)
+	template<typename CellL> void ghost_candidates_from_cells(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
+															  size_t g_m,
+															  CellL & cl)
 	{
-		if (opt & RUN_ON_DEVICE)
+		// the skin cells depend only on the decomposition and on the geometry of the cell-list
+		bool skin_valid = (skin_ndec == (long int)dec.get_ndec());
+
+		auto & gi = cl.getGrid();
+		Point<dim,St> spacing = cl.getCellBox().getP2();
+		grid_key_dx<dim> orig = cl.getCellGrid_me(dec.getProcessorBounds().getP1());
+
+		for (size_t i = 0 ; i < dim ; i++)
 		{
-			std::cout << "Error: " << __FILE__ << ":" << __LINE__ << " map_list is unsupported on device (coming soon)" << std::endl;
-			return;
+			if (skin_div[i] != gi.size(i) || skin_spacing.get(i) != spacing.get(i) || skin_orig.get(i) != orig.get(i))
+			{skin_valid = false;}
 		}
 
-		typedef KillParticle obp;
+		if (skin_valid == false)
+		{
+			dec.getInternalGhostCells(cl,skin_cells);
 
-		// Processor communication size
-		openfpm::vector<aggregate<unsigned int,unsigned int>,Memory,layout_base> prc_sz(v_cl.getProcessingUnits());
+			skin_ndec = dec.get_ndec();
+			for (size_t i = 0 ; i < dim ; i++)
+			{skin_div[i] = gi.size(i);}
+			skin_spacing = spacing;
+			skin_orig = orig;
+		}
 
-		// map completely reset the ghost part
-		v_pos.resize(g_m);
-		v_prp.resize(g_m);
+		ghost_cand.clear();
+		for (size_t i = 0 ; i < skin_cells.size() ; i++)
+		{
+			size_t cell = skin_cells.get(i);
 
-		// m_opart, Contain the processor id of each particle (basically where they have to go)
-		labelParticleProcessor<obp>(v_pos,m_opart, prc_sz,opt);
+			for (size_t j = 0 ; j < cl.getNelements(cell) ; j++)
+			{
+				size_t p = cl.get(cell,j);
 
-		// Calculate the sending buffer size for each processor, put this information in
-		// a contiguous buffer
-		p_map_req.resize(v_cl.getProcessingUnits());
+				// the cell-list can contain ghost particles
+				if (p < g_m)
+				{ghost_cand.add(p);}
+			}
+		}
+
+		// keep the order of the full labelling
+		ghost_cand.sort();
+
+		ghost_cand_active = true;
+	}
+
+	/*! \brief Send the properties prp of the ghost particles with reduced precision (GHOST_REDUCED_PRECISION)
+	 *
+	 * The double are sent as float and converted back on receive, the particles must be already labelled
+	 *
+	 * \tparam prp properties to send
+	 *
+	 * \param v_prp vector of particle properties
+	 * \param g_m ghost marker
+	 * \param opt options
+	 *
+	 */
+	template<int ... prp> void ghost_get_reduced_prp(openfpm::vector<prop,Memory,layout_base> & v_prp,
+			                                         size_t g_m,
+			                                         size_t opt)
+	{
+		typedef typename to_boost_vmpl<prp...>::type v_mpl;
+
+		// properties to send in reduced precision
+		typedef aggregate<typename ghost_reduced_type<typename boost::mpl::at<typename prop::type,
+		                                                                      boost::mpl::int_<prp>>::type>::type ...> red_type;
+
+		typedef openfpm::vector<red_type,Memory,memory_traits_lin,openfpm::grow_policy_identity> red_vector;
+
+		openfpm::vector<red_vector> g_send_red;
+		red_vector g_recv_red;
+
+		// the send buffers are set on the retained memory hsmem like in fill_send_ghost_prp_buf
+		g_send_red.resize(prc_sz_gg.size());
+
+		resize_retained_buffer(hsmem,g_send_red.size());
+
+		for (size_t i = 0; i < hsmem.size(); i++)
+		{
+			if (hsmem.get(i).ref() == 0)
+			{hsmem.get(i).incRef();}
+		}
+
+		size_t k = 0;
+		for (size_t i = 0 ; i < g_send_red.size() ; i++)
+		{k = set_mem_retained_buffers<false,red_vector,v_mpl>::set_mem_retained_buffers_(g_send_red,prc_sz_gg,i,hsmem,k);}
+
+		// the receive buffer is retained in hrmem_red
+		resize_retained_buffer(hrmem_red,1);
+
+		if (hrmem_red.get(0).ref() == 0)
+		{hrmem_red.get(0).incRef();}
+
+		g_recv_red.setMemory(hrmem_red.get(0));
+
+		for (size_t i = 0 ; i < g_opart.size() ; i++)
+		{
+			for (size_t j = 0 ; j < g_opart.get(i).size() ; j++)
+			{
+				auto src = v_prp.get(g_opart.get(i).template get<0>(j));
+				auto dst = g_send_red.get(i).get(j);
+
+				ghost_reduced_copy<true,prop,v_mpl,decltype(src),decltype(dst)> cp(src,dst);
+				boost::mpl::for_each_ref<boost::mpl::range_c<int,0,sizeof...(prp)>>(cp);
+			}
+		}
+
+		prc_recv_get_prp.clear();
+		recv_sz_get_prp.clear();
+
+		v_cl.template SSendRecv<red_vector,red_vector,memory_traits_lin>(g_send_red,g_recv_red,prc_g_opart,prc_recv_get_prp,recv_sz_get_prp);
+
+		// fill g_opart_sz
+		g_opart_sz.resize(prc_g_opart.size());
+
+		for (size_t i = 0 ; i < prc_g_opart.size() ; i++)
+		{g_opart_sz.get(i) = g_send_red.get(i).size();}
+
+		// the received particles follow the domain particles
+		if (!(opt & SKIP_LABELLING))
+		{v_prp.resize(g_m + g_recv_red.size());}
+
+		for (size_t i = 0 ; i < g_recv_red.size() ; i++)
+		{
+			auto src = g_recv_red.get(i);
+			auto dst = v_prp.get(g_m + i);
+
+			ghost_reduced_copy<false,prop,v_mpl,decltype(dst),decltype(src)> cp(dst,src);
+			boost::mpl::for_each_ref<boost::mpl::range_c<int,0,sizeof...(prp)>>(cp);
+		}
+	}
+
+	/*! \brief It synchronize the properties and position of the ghost particles
+	 *
+	 * \tparam prp list of properties to get synchronize
+	 *
+	 * \param opt options WITH_POSITION, it send also the positional information of the particles
+	 * \param v_pos vector of position to update
+	 * \param v_prp vector of properties to update
+	 * \param g_m marker between real and ghost particles
+	 *
+	 */
+	template<unsigned int impl, int ... prp> inline void ghost_get_(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
+												 openfpm::vector<prop,Memory,layout_base> & v_prp,
+												 size_t & g_m,
+												 size_t opt = WITH_POSITION)
+	{
+#ifdef PROFILE_SCOREP
+		SCOREP_USER_REGION("ghost_get",SCOREP_USER_REGION_TYPE_FUNCTION)
+#endif
+
+		// Sending property object
+		typedef object<typename object_creator<typename prop::type, prp...>::type> prp_object;
+
+		// send vector for each processor
+		typedef openfpm::vector<prp_object,Memory,layout_base,openfpm::grow_policy_identity> send_vector;
+
+		size_t req_prp = prp_mask<prp...>();
+
+		fold_changes();
+
+		// if nobody moved its particles we reuse the last labelling, if nobody changed the properties there is nothing to do
+		if (impl == GHOST_SYNC && (opt & GHOST_AUTO_REUSE) && !(opt & SKIP_LABELLING) && !(opt & RUN_ON_DEVICE))
+		{
+			size_t reuse = ghost_reuse_check(g_m,req_prp,sizeof...(prp) != 0,opt);
+
+			if (reuse == GHOST_REUSE_ALL)
+			{
+				ghost_candidates_clear();
+				return;
+			}
+			else if (reuse == GHOST_REUSE_LABELLING)
+			{opt |= SKIP_LABELLING;}
+		}
+
+		if (!(opt & NO_POSITION))
+		{v_pos.resize(g_m);}
+
+		// reset the ghost part
+
+		if (!(opt & SKIP_LABELLING))
+		{v_prp.resize(g_m);}
+
+		// Label all the particles
+		if ((opt & SKIP_LABELLING) == false)
+		{labelParticlesGhost(v_pos,v_prp,prc_g_opart,prc_sz_gg,prc_offset,g_m,opt);}
+
+		bool reduced = (opt & GHOST_REDUCED_PRECISION) && impl == GHOST_SYNC && !(opt & RUN_ON_DEVICE) && sizeof...(prp) != 0;
+
+		if (reduced == true)
+		{ghost_get_reduced_prp<prp...>(v_prp,g_m,opt);}
+		else
+		{
+			// Send and receive ghost particle information
+			openfpm::vector<send_vector> g_send_prp;
+
+			fill_send_ghost_prp_buf<send_vector, prp_object, prp...>(v_prp,prc_sz_gg,g_send_prp,opt);
+
+	#if defined(CUDA_GPU) && defined(__NVCC__)
+			cudaDeviceSynchronize();
+	#endif
+
+			// if there are no properties skip
+			// SSendRecvP send everything when we do not give properties
+
+			ghost_exchange_comm_impl<impl,layout_base,prp ...>::template
+			sendrecv_prp(v_cl,g_send_prp,v_prp,v_pos,prc_g_opart,
+					 prc_recv_get_prp,recv_sz_get_prp,recv_sz_get_byte,g_opart_sz,g_m,opt);
+		}
+
+		if (!(opt & NO_POSITION))
+		{
+			// Sending buffer for the ghost particles position
+			openfpm::vector<send_pos_vector> g_pos_send;
+
+			fill_send_ghost_pos_buf(v_pos,prc_sz_gg,g_pos_send,opt,impl == GHOST_ASYNC);
+
+#if defined(CUDA_GPU) && defined(__NVCC__)
+			cudaDeviceSynchronize();
+#endif
+
+			ghost_exchange_comm_impl<impl,layout_base,prp ...>::template
+			sendrecv_pos(v_cl,g_pos_send,v_prp,v_pos,prc_recv_get_pos,recv_sz_get_pos,prc_g_opart,opt);
+
+            // fill g_opart_sz
+            g_opart_sz.resize(prc_g_opart.size());
+
+			for (size_t i = 0 ; i < prc_g_opart.size() ; i++)
+				g_opart_sz.get(i) = g_pos_send.get(i).size();
+		}
+
+        // Important to ensure that the number of particles in v_prp must be equal to v_pos
+        // Note that if we do not give properties sizeof...(prp) == 0 in general at this point
+        // v_prp.size() != v_pos.size()
+        if (!(opt & SKIP_LABELLING))
+        {
+                v_prp.resize(v_pos.size());
+        }
+
+		add_loc_particles_bc(v_pos,v_prp,g_m,opt);
+
+		// the candidates are valid only for one labelling
+		ghost_candidates_clear();
+
+		if (!(opt & SKIP_LABELLING))
+		{
+			gg_lab_valid = !(opt & RUN_ON_DEVICE);
+			gg_lab_version = v_pos_version;
+			gg_lab_g_m = g_m;
+			gg_lab_ndec = dec.get_ndec();
+			gg_lab_pos = !(opt & NO_POSITION);
+			gg_lab_prp = sizeof...(prp) != 0;
+			gg_lab_epoch++;
+
+			prp_ghost_valid = 0;
+		}
+
+		// the ghost received in reduced precision are not valid for a following full precision ghost_get
+		if (reduced == true)
+		{prp_ghost_valid &= ~req_prp;}
+		else
+		{prp_ghost_valid |= req_prp;}
+
+		prp_dirty = (prp_dirty & ~req_prp) | prp_bit(63);
+	}
+
+	/*! \brief It synchronize the properties and position of the ghost particles
+	 *
+	 * \tparam prp list of properties to get synchronize
+	 *
+	 * \param opt options WITH_POSITION, it send also the positional information of the particles
+	 * \param v_pos vector of position to update
+	 * \param v_prp vector of properties to update
+	 * \param g_m marker between real and ghost particles
+	 *
+	 */
+	template<int ... prp> inline void ghost_wait_(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
+			 	 	 	 	 	 	 	 	 	 	 	 	 	 	 openfpm::vector<prop,Memory,layout_base> & v_prp,
+			 	 	 	 	 	 	 	 	 	 	 	 	 	 	 size_t & g_m,
+			 	 	 	 	 	 	 	 	 	 	 	 	 	 	 size_t opt = WITH_POSITION)
+	{
+		// Sending property object
+		typedef object<typename object_creator<typename prop::type, prp...>::type> prp_object;
+
+		// send vector for each processor
+		typedef openfpm::vector<prp_object,Memory,layout_base,openfpm::grow_policy_identity> send_vector;
+
+		// Send and receive ghost particle information
+		openfpm::vector<send_vector> g_send_prp;
+		openfpm::vector<send_pos_vector> g_pos_send;
+
+		ghost_exchange_comm_impl<GHOST_ASYNC,layout_base,prp ...>::template
+		sendrecv_prp_wait(v_cl,g_send_prp,v_prp,v_pos,prc_g_opart,
+					 prc_recv_get_prp,recv_sz_get_prp,recv_sz_get_byte,g_opart_sz,g_m,opt);
+
+
+		ghost_exchange_comm_impl<GHOST_ASYNC,layout_base,prp ...>::template
+		sendrecv_pos_wait(v_cl,g_pos_send,v_prp,v_pos,prc_recv_get_pos,recv_sz_get_pos,prc_g_opart,opt);
+	}
+
+	/*! \brief It move all the particles that does not belong to the local processor to the respective processor
+	 *
+	 * \tparam out of bound policy it specify what to do when the particles are detected out of bound
+	 *
+	 * In general this function is called after moving the particles to move the
+	 * elements out the local processor. Or just after initialization if each processor
+	 * contain non local particles
+	 *
+	 * \tparam prp properties to communicate
+	 *
+	 * \param v_pos vector of particle positions
+	 * \param v_prp vector of particle properties
+	 * \param g_m ghost marker
+	 * \param opt options
+	 *
+	 */
+	template<unsigned int ... prp> void map_list_(openfpm::vector<Point<dim, St>> & v_pos, openfpm::vector<prop> & v_prp, size_t & g_m, size_t opt)
+	{
+		if (opt & RUN_ON_DEVICE)
+		{
+			std::cout << "Error: " << __FILE__ << ":" << __LINE__ << " map_list is unsupported on device (coming soon)" << std::endl;
+			return;
+		}
+
+		typedef KillParticle obp;
+
+		// particles are going to be reordered
+		lazy_map_invalidate();
+		ghost_labelling_invalidate();
+
+		// Processor communication size
+		openfpm::vector<aggregate<unsigned int,unsigned int>,Memory,layout_base> prc_sz(v_cl.getProcessingUnits());
+
+		// map completely reset the ghost part
+		v_pos.resize(g_m);
+		v_prp.resize(g_m);
+
+		// m_opart, Contain the processor id of each particle (basically where they have to go)
+		labelParticleProcessor<obp>(v_pos,m_opart, prc_sz,opt);
+
+		// Calculate the sending buffer size for each processor, put this information in
+		// a contiguous buffer
+		p_map_req.resize(v_cl.getProcessingUnits());
 		openfpm::vector<size_t> prc_sz_r;
 		openfpm::vector<size_t> prc_r;
 
@@ -2034,74 +3087,741 @@ public:
 
 	/*! \brief It move all the particles that does not belong to the local processor to the respective processor
 	 *
-	 * \tparam out of bound policy it specify what to do when the particles are detected out of bound
+	 * \tparam out of bound policy it specify what to do when the particles are detected out of bound
+	 *
+	 * In general this function is called after moving the particles to move the
+	 * elements out the local processor. Or just after initialization if each processor
+	 * contain non local particles
+	 *
+	 * \param v_pos vector of particle positions
+	 * \param v_prp vector of particle properties
+	 * \param g_m ghost marker
+	 *
+	 */
+	template<typename obp = KillParticle>
+	void map_(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
+			  openfpm::vector<prop,Memory,layout_base> & v_prp, size_t & g_m,
+			  size_t opt)
+	{
+#ifdef PROFILE_SCOREP
+		SCOREP_USER_REGION("map",SCOREP_USER_REGION_TYPE_FUNCTION)
+#endif
+
+		// map completely reset the ghost part
+		ghost_labelling_invalidate();
+
+		if ((opt & MAP_LAZY) && !(opt & RUN_ON_DEVICE))
+		{
+			map_lazy_<obp>(v_pos,v_prp,g_m,opt);
+			return;
+		}
+
+		// particles are going to be reordered
+		lazy_map_invalidate();
+
+		prc_sz.resize(v_cl.getProcessingUnits());
+
+		// map completely reset the ghost part
+		v_pos.resize(g_m);
+		v_prp.resize(g_m);
+
+		// Contain the processor id of each particle (basically where they have to go)
+		labelParticleProcessor<obp>(v_pos,m_opart, prc_sz,opt);
+
+		map_exchange_(v_pos,v_prp,g_m,opt);
+	}
+
+	/*! \brief Send the particles labelled in m_opart to the processors where they should go and receive the incoming one
+	 *
+	 * \param v_pos vector of particle positions
+	 * \param v_prp vector of particle properties
+	 * \param g_m ghost marker
+	 * \param opt options
+	 *
+	 */
+	void map_exchange_(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
+					   openfpm::vector<prop,Memory,layout_base> & v_prp, size_t & g_m,
+					   size_t opt)
+	{
+		openfpm::vector<size_t> prc_sz_r;
+		openfpm::vector<size_t> prc_r;
+
+		// Calculate the sending buffer size for each processor, put this information in
+		// a contiguous buffer
+		calc_send_buffers(prc_sz,prc_sz_r,prc_r,opt);
+
+		if ((opt & MAP_SEND_ARENA) && !(opt & RUN_ON_DEVICE) && is_layout_inte<layout_base<prop>>::value == false)
+		{
+			map_arena_(v_pos,v_prp,prc_sz_r,prc_r);
+
+			g_m = v_pos.size();
+			return;
+		}
+
+		//! position vector
+		openfpm::vector<openfpm::vector<Point<dim, St>,Memory,layout_base,openfpm::grow_policy_identity>> m_pos;
+		//! properties vector
+		openfpm::vector<openfpm::vector<prop,Memory,layout_base,openfpm::grow_policy_identity>> m_prp;
+
+		fill_send_map_buf(v_pos,v_prp, prc_sz_r,prc_r, m_pos, m_prp,prc_sz,opt);
+
+		size_t opt_ = 0;
+		if (opt & RUN_ON_DEVICE)
+		{
+#if defined(CUDA_GPU) && defined(__NVCC__)
+			// Before doing the communication on RUN_ON_DEVICE we have to be sure that the previous kernels complete
+			cudaDeviceSynchronize();
+			opt_ |= MPI_GPU_DIRECT;
+#else
+			std::cout << __FILE__ << ":" << __LINE__ << " error: to use the option RUN_ON_DEVICE you must compile with NVCC" << std::endl;
+#endif
+		}
+
+		v_cl.template SSendRecv<openfpm::vector<Point<dim, St>,Memory,layout_base,openfpm::grow_policy_identity>,
+					   openfpm::vector<Point<dim, St>,Memory,layout_base>,
+					   layout_base>
+					   (m_pos,v_pos,prc_r,prc_recv_map,recv_sz_map,opt_);
+
+		v_cl.template SSendRecv<openfpm::vector<prop,Memory,layout_base,openfpm::grow_policy_identity>,
+					   openfpm::vector<prop,Memory,layout_base>,
+					   layout_base>
+					   (m_prp,v_prp,prc_r,prc_recv_map,recv_sz_map,opt_);
+
+		// mark the ghost part
+
+		g_m = v_pos.size();
+	}
+
+	/*! \brief Construct the cell-list that for each cell of the processor bounding box store the local sub-domains
+	 *        that intersect it
+	 *
+	 * The cells have the size of the cells of the decomposition, so every cell contain few sub-domains
+	 *
+	 */
+	void lazy_map_cell_list()
+	{
+		lazy_cl_ndec = dec.get_ndec();
+
+		lazy_bound = dec.getProcessorBounds();
+
+		lazy_cl.clear();
+
+		if (lazy_bound.isValidN() == false)
+		{return;}
+
+		size_t div[dim];
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			div[i] = (size_t)((lazy_bound.getHigh(i) - lazy_bound.getLow(i)) / dec.getCellDecomposer().getCellBox().getP2()[i]);
+			if (div[i] == 0)	{div[i] = 1;}
+		}
+
+		lazy_cl.Initialize(lazy_bound,div);
+
+		auto & gi = lazy_cl.getGrid();
+
+		for (size_t i = 0 ; i < dec.getNSubDomain() ; i++)
+		{
+			SpaceBox<dim,St> sub = dec.getSubDomain(i);
+
+			// get the cells this box span
+			const grid_key_dx<dim> p1 = lazy_cl.getCellGrid_me(sub.getP1());
+			const grid_key_dx<dim> p2 = lazy_cl.getCellGrid_pe(sub.getP2());
+
+			grid_key_dx_iterator_sub<dim> g_sub(gi,p1,p2);
+
+			while (g_sub.isNext())
+			{
+				auto key = g_sub.get();
+				lazy_cl.addCell(gi.LinId(key),i);
+
+				++g_sub;
+			}
+		}
+	}
+
+	/*! \brief Distance of a point from the border of the local sub-domain that contain it
+	 *
+	 * Only the sub-domains in the cell of the point are checked
+	 *
+	 * \param p point
+	 *
+	 * \return the distance, 0 if the point is not inside any local sub-domain
+	 *
+	 */
+	St lazy_map_dist(const Point<dim,St> & p)
+	{
+		if (lazy_bound.isValidN() == false || lazy_bound.isInside(p) == false)
+		{return 0;}
+
+		size_t cell = lazy_cl.getCell(p);
+
+		for (size_t j = 0 ; j < lazy_cl.getNelements(cell) ; j++)
+		{
+			SpaceBox<dim,St> sub = dec.getSubDomain(lazy_cl.get(cell,j));
+
+			if (sub.isInside(p) == false)
+			{continue;}
+
+			St d = std::numeric_limits<St>::max();
+			for (size_t k = 0 ; k < dim ; k++)
+			{
+				d = std::min(d,p.get(k) - sub.getLow(k));
+				d = std::min(d,sub.getHigh(k) - p.get(k));
+			}
+
+			return d;
+		}
+
+		return 0;
+	}
+
+	/*! \brief Store the actual position of the particles and their distance from the border of the sub-domain
+	 *
+	 * \param v_pos vector of particle positions
+	 * \param g_m ghost marker
+	 *
+	 */
+	void lazy_map_update(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos, size_t g_m)
+	{
+		if (lazy_cl_ndec != (long int)dec.get_ndec())
+		{lazy_map_cell_list();}
+
+		lazy_pos.resize(g_m);
+		lazy_dist.resize(g_m);
+
+		for (size_t i = 0 ; i < g_m ; i++)
+		{
+			Point<dim,St> p = v_pos.get(i);
+
+			lazy_pos.get(i) = p;
+			lazy_dist.get(i) = lazy_map_dist(p);
+		}
+
+		lazy_ndec = dec.get_ndec();
+		lazy_valid = true;
+	}
+
+	/*! \brief Move the particles that does not belong to the local processor, relabelling only the particles that can have left
+	 *
+	 * A particle can have left its sub-domain only if its displacement from the last lazy map is bigger than its distance
+	 * from the border of the sub-domain. Only these particles are labelled, and if no processor has particles to send, the
+	 * communication is reduced to one reduction
+	 *
+	 * \tparam obp out of bound policy it specify what to do when the particles are detected out of bound
+	 *
+	 * \param v_pos vector of particle positions
+	 * \param v_prp vector of particle properties
+	 * \param g_m ghost marker
+	 * \param opt options
+	 *
+	 */
+	template<typename obp> void map_lazy_(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
+										  openfpm::vector<prop,Memory,layout_base> & v_prp, size_t & g_m,
+										  size_t opt)
+	{
+		prc_sz.resize(v_cl.getProcessingUnits());
+
+		// map completely reset the ghost part
+		v_pos.resize(g_m);
+		v_prp.resize(g_m);
+
+		size_t rank = v_cl.getProcessUnitID();
+
+		// The choice between the lazy labelling and the full labelling must be the same on all processors,
+		// because they communicate differently. A processor without valid lazy information ask for a full
+		// labelling: 2 full labelling, 1 lazy labelling with migration, 0 nothing to do
+		size_t lazy_state = 0;
+
+		if (lazy_valid == false || lazy_pos.size() != g_m || lazy_ndec != (long int)dec.get_ndec())
+		{lazy_state = 2;}
+		else
+		{
+			m_opart.clear();
+			prc_sz_gg.clear();
+			o_part_loc.clear();
+			g_opart.clear();
+			prc_g_opart.clear();
+			prc_sz.template fill<0>(0);
+
+			for (size_t key = 0 ; key < g_m ; key++)
+			{
+				Point<dim,St> p = v_pos.get(key);
+
+				St dist = lazy_dist.get(key);
+
+				// The particle cannot have left its sub-domain
+				if (p.distance2(lazy_pos.get(key)) < dist*dist)
+				{continue;}
+
+				// Apply the boundary conditions
+				dec.applyPointBC(v_pos.get(key));
+
+				long int p_id = 0;
+
+				// Check if the particle is inside the domain
+				if (dec.getDomain().isInside(v_pos.get(key)) == true)
+				{p_id = dec.processorID(v_pos.get(key));}
+				else
+				{p_id = obp::out(key, rank);}
+
+				if (p_id != (long int)rank)
+				{
+					if (p_id != -1)
+					{prc_sz.template get<0>(p_id)++;}
+
+					m_opart.add();
+					m_opart.last().template get<0>() = key;
+					m_opart.last().template get<2>() = p_id;
+				}
+				else
+				{
+					// still here, start again from the new position
+					lazy_pos.get(key) = v_pos.get(key);
+					lazy_dist.get(key) = lazy_map_dist(lazy_pos.get(key));
+				}
+			}
+
+			lazy_state = (m_opart.size() != 0);
+		}
+
+		v_cl.max(lazy_state);
+		v_cl.execute();
+
+		if (lazy_state == 0)
+		{return;}
+
+		if (lazy_state == 2)
+		{
+			// somebody does not have valid information, so everybody label everything
+			labelParticleProcessor<obp>(v_pos,m_opart,prc_sz,opt);
+		}
+
+		map_exchange_(v_pos,v_prp,g_m,opt);
+
+		lazy_map_update(v_pos,g_m);
+	}
+
+	/*! \brief It start to move all the particles that does not belong to the local processor to the respective processor
+	 *
+	 * The particles that has to migrate are removed from v_pos and v_prp and the communication is started, but
+	 * this function does not wait for it to complete. At return v_pos and v_prp contain only the particles
+	 * that remain on this processor and can be used. The incoming particles are appended by map_wait_
+	 *
+	 * \tparam obp out of bound policy it specify what to do when the particles are detected out of bound
+	 *
+	 * \param v_pos vector of particle positions
+	 * \param v_prp vector of particle properties
+	 * \param g_m ghost marker
+	 * \param opt options
+	 *
+	 */
+	template<typename obp = KillParticle>
+	void Imap_(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
+			   openfpm::vector<prop,Memory,layout_base> & v_prp, size_t & g_m,
+			   size_t opt)
+	{
+#ifdef PROFILE_SCOREP
+		SCOREP_USER_REGION("Imap",SCOREP_USER_REGION_TYPE_FUNCTION)
+#endif
+
+		// particles are going to be reordered
+		lazy_map_invalidate();
+		ghost_labelling_invalidate();
+
+		prc_sz.resize(v_cl.getProcessingUnits());
+
+		// map completely reset the ghost part
+		v_pos.resize(g_m);
+		v_prp.resize(g_m);
+
+		// Contain the processor id of each particle (basically where they have to go)
+		labelParticleProcessor<obp>(v_pos,m_opart, prc_sz,opt);
+
+		openfpm::vector<size_t> prc_sz_r;
+		prc_send_map.clear();
+
+		// Calculate the sending buffer size for each processor, put this information in
+		// a contiguous buffer
+		calc_send_buffers(prc_sz,prc_sz_r,prc_send_map,opt);
+
+		//! position vector
+		openfpm::vector<openfpm::vector<Point<dim, St>,Memory,layout_base,openfpm::grow_policy_identity>> m_pos;
+		//! properties vector
+		openfpm::vector<openfpm::vector<prop,Memory,layout_base,openfpm::grow_policy_identity>> m_prp;
+
+		// the sending buffers are retained, so they survive until map_wait_
+		fill_send_map_buf(v_pos,v_prp, prc_sz_r,prc_send_map, m_pos, m_prp,prc_sz,opt);
+
+		size_t opt_ = 0;
+		if (opt & RUN_ON_DEVICE)
+		{
+#if defined(CUDA_GPU) && defined(__NVCC__)
+			// Before doing the communication on RUN_ON_DEVICE we have to be sure that the previous kernels complete
+			cudaDeviceSynchronize();
+			opt_ |= MPI_GPU_DIRECT;
+#else
+			std::cout << __FILE__ << ":" << __LINE__ << " error: to use the option RUN_ON_DEVICE you must compile with NVCC" << std::endl;
+#endif
+		}
+
+		prc_recv_map.clear();
+		recv_sz_map.clear();
+		prc_recv_map_prp.clear();
+		recv_sz_map_prp.clear();
+
+		v_cl.template SSendRecvAsync<openfpm::vector<Point<dim, St>,Memory,layout_base,openfpm::grow_policy_identity>,
+					   openfpm::vector<Point<dim, St>,Memory,layout_base>,
+					   layout_base>
+					   (m_pos,v_pos,prc_send_map,prc_recv_map,recv_sz_map,opt_);
+
+		v_cl.template SSendRecvAsync<openfpm::vector<prop,Memory,layout_base,openfpm::grow_policy_identity>,
+					   openfpm::vector<prop,Memory,layout_base>,
+					   layout_base>
+					   (m_prp,v_prp,prc_send_map,prc_recv_map_prp,recv_sz_map_prp,opt_);
+
+		// Only the particles that stay are real particles until map_wait_
+		g_m = v_pos.size();
+	}
+
+	/*! \brief It wait the completion of an asynchronous map started with Imap_ and append the incoming particles
+	 *
+	 * \param v_pos vector of particle positions
+	 * \param v_prp vector of particle properties
+	 * \param g_m ghost marker
+	 * \param opt options
+	 *
+	 */
+	void map_wait_(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
+				   openfpm::vector<prop,Memory,layout_base> & v_prp, size_t & g_m,
+				   size_t opt)
+	{
+		// Any ghost created in the meanwhile is removed, incoming particles are appended after the local one
+		ghost_labelling_invalidate();
+		v_pos.resize(g_m);
+		v_prp.resize(g_m);
+
+		//! position vector
+		openfpm::vector<openfpm::vector<Point<dim, St>,Memory,layout_base,openfpm::grow_policy_identity>> m_pos;
+		//! properties vector
+		openfpm::vector<openfpm::vector<prop,Memory,layout_base,openfpm::grow_policy_identity>> m_prp;
+
+		size_t opt_ = 0;
+		if (opt & RUN_ON_DEVICE)
+		{
+#if defined(CUDA_GPU) && defined(__NVCC__)
+			opt_ |= MPI_GPU_DIRECT;
+#endif
+		}
+
+		v_cl.template SSendRecvWait<openfpm::vector<Point<dim, St>,Memory,layout_base,openfpm::grow_policy_identity>,
+					   openfpm::vector<Point<dim, St>,Memory,layout_base>,
+					   layout_base>
+					   (m_pos,v_pos,prc_send_map,prc_recv_map,recv_sz_map,opt_);
+
+		v_cl.template SSendRecvWait<openfpm::vector<prop,Memory,layout_base,openfpm::grow_policy_identity>,
+					   openfpm::vector<prop,Memory,layout_base>,
+					   layout_base>
+					   (m_prp,v_prp,prc_send_map,prc_recv_map_prp,recv_sz_map_prp,opt_);
+
+		// mark the ghost part
+
+		g_m = v_pos.size();
+	}
+
+	/*! \brief Encode the number of migrating particles of a map_and_ghost_get message into a position
+	 *
+	 * The number is split in digits that are exactly representable in St, one digit for each component
+	 *
+	 * \param n number of migrating particles
+	 *
+	 * \return the encoded position
+	 *
+	 */
+	Point<dim,St> mig_count_encode(size_t n)
+	{
+		const size_t base = (size_t)1 << std::min(std::numeric_limits<St>::digits,32);
+
+		Point<dim,St> p;
+		for (size_t i = 0 ; i < dim ; i++)
+		{
+			p.get(i) = (St)(n % base);
+			n /= base;
+		}
+
+		if (n != 0)
+		{std::cerr << "Error: " << __FILE__ << ":" << __LINE__ << " the number of migrating particles cannot be encoded in a position" << std::endl;}
+
+		return p;
+	}
+
+	/*! \brief Decode the number of migrating particles of a map_and_ghost_get message
+	 *
+	 * \param p position encoded with mig_count_encode
+	 *
+	 * \return the number of migrating particles
+	 *
+	 */
+	size_t mig_count_decode(const Point<dim,St> & p)
+	{
+		const size_t base = (size_t)1 << std::min(std::numeric_limits<St>::digits,32);
+
+		size_t n = 0;
+		for (long int i = dim-1 ; i >= 0 ; i--)
+		{n = n*base + (size_t)p.get(i);}
+
+		return n;
+	}
+
+	/*! \brief It move the particles to the owner processor and create the ghost particles in a single communication round
+	 *
+	 * The particles are labelled in one pass, for each particle we compute the owner and the processors that
+	 * require it as ghost. For the particles that stay the ghost processors come from the internal ghost boxes, for the
+	 * particles that migrate from the global decomposition. The message for each processor contain the migrating particles, followed
+	 * by the ghost particles. The position message carry one additional trailing element that store the number of migrating
+	 * particles of the message, so the receiver can split migrating and ghost particles without an additional communication round
+	 *
+	 * \note ghost particles carry all the properties. The labelling of a following ghost_get cannot be skipped (SKIP_LABELLING)
+	 *       and ghost_put require a ghost_get
 	 *
-	 * In general this function is called after moving the particles to move the
-	 * elements out the local processor. Or just after initialization if each processor
-	 * contain non local particles
+	 * \tparam obp out of bound policy it specify what to do when the particles are detected out of bound
 	 *
 	 * \param v_pos vector of particle positions
 	 * \param v_prp vector of particle properties
 	 * \param g_m ghost marker
+	 * \param opt options
 	 *
 	 */
 	template<typename obp = KillParticle>
-	void map_(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
-			  openfpm::vector<prop,Memory,layout_base> & v_prp, size_t & g_m,
-			  size_t opt)
+	void map_and_ghost_get_(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
+							openfpm::vector<prop,Memory,layout_base> & v_prp, size_t & g_m,
+							size_t opt)
 	{
 #ifdef PROFILE_SCOREP
-		SCOREP_USER_REGION("map",SCOREP_USER_REGION_TYPE_FUNCTION)
+		SCOREP_USER_REGION("map_and_ghost_get",SCOREP_USER_REGION_TYPE_FUNCTION)
 #endif
 
-		prc_sz.resize(v_cl.getProcessingUnits());
+		// particles are going to be reordered
+		lazy_map_invalidate();
+		ghost_labelling_invalidate();
+
+		if (opt & RUN_ON_DEVICE)
+		{
+			std::cout << "Error: " << __FILE__ << ":" << __LINE__ << " map_and_ghost_get is unsupported on device, use map and ghost_get" << std::endl;
+			return;
+		}
+
+		size_t n_proc = v_cl.getProcessingUnits();
+		size_t rank = v_cl.getProcessUnitID();
+
+		prc_sz.resize(n_proc);
+		prc_sz.template fill<0>(0);
 
 		// map completely reset the ghost part
 		v_pos.resize(g_m);
 		v_prp.resize(g_m);
 
-		// Contain the processor id of each particle (basically where they have to go)
-		labelParticleProcessor<obp>(v_pos,m_opart, prc_sz,opt);
+		// the ghost labelling of the last ghost_get is invalidated
+		m_opart.clear();
+		prc_sz_gg.clear();
+		o_part_loc.clear();
+		g_opart.clear();
+		prc_g_opart.clear();
+		prc_recv_get_pos.clear();
+		recv_sz_get_pos.clear();
+		prc_recv_get_prp.clear();
+		recv_sz_get_prp.clear();
 
-		openfpm::vector<size_t> prc_sz_r;
+		// for each processor the particles (and shift) to send as ghost
+		openfpm::vector<openfpm::vector<aggregate<size_t,size_t>>> g_lbl(n_proc);
+
+		// Label all the particles with the owner processor and the ghost processors
+		auto it = v_pos.getIterator();
+
+		while (it.isNext())
+		{
+			auto key = it.get();
+
+			// Apply the boundary conditions
+			dec.applyPointBC(v_pos.get(key));
+
+			Point<dim,St> p = v_pos.get(key);
+
+			long int p_id = 0;
+
+			// Check if the particle is inside the domain
+			if (dec.getDomain().isInside(p) == true)
+			{p_id = dec.processorID(p);}
+			else
+			{p_id = obp::out(key, rank);}
+
+			if (p_id == (long int)rank)
+			{
+				const openfpm::vector<std::pair<size_t, size_t>> & vp_id = dec.template ghost_processorID_pair<typename Decomposition::lc_processor_id, typename Decomposition::shift_id>(p, UNIQUE);
+
+				for (size_t i = 0; i < vp_id.size(); i++)
+				{
+					auto & lbl = g_lbl.get(dec.IDtoProc(vp_id.get(i).first));
+					lbl.add();
+					lbl.last().template get<0>() = key;
+					lbl.last().template get<1>() = vp_id.get(i).second;
+				}
+			}
+			else
+			{
+				// Particle to move (or to kill)
+				m_opart.add();
+				m_opart.last().template get<0>() = key;
+				m_opart.last().template get<2>() = p_id;
+
+				if (p_id != -1)
+				{
+					prc_sz.template get<0>(p_id)++;
+
+					const openfpm::vector<std::pair<size_t, size_t>> & vp_id = dec.ghost_processorID_global(p,p_id);
+
+					for (size_t i = 0; i < vp_id.size(); i++)
+					{
+						auto & lbl = g_lbl.get(vp_id.get(i).first);
+						lbl.add();
+						lbl.last().template get<0>() = key;
+						lbl.last().template get<1>() = vp_id.get(i).second;
+					}
+				}
+			}
+
+			++it;
+		}
+
+		// get the shift vectors
+		const openfpm::vector<Point<dim,St>,Memory,layout_base> & shifts = dec.getShiftVectors();
+
+		// list of processors to communicate with and number of migrating particles for each of them
 		openfpm::vector<size_t> prc_r;
+		openfpm::vector<size_t> prc_sz_r;
 
-		// Calculate the sending buffer size for each processor, put this information in
-		// a contiguous buffer
-		calc_send_buffers(prc_sz,prc_sz_r,prc_r,opt);
+		p_map_req.resize(n_proc);
+		for (size_t i = 0; i < n_proc; i++)
+		{
+			if (i != rank && (prc_sz.template get<0>(i) != 0 || g_lbl.get(i).size() != 0))
+			{
+				p_map_req.get(i) = prc_r.size();
+				prc_r.add(i);
+				prc_sz_r.add(prc_sz.template get<0>(i));
+			}
+		}
 
 		//! position vector
-		openfpm::vector<openfpm::vector<Point<dim, St>,Memory,layout_base,openfpm::grow_policy_identity>> m_pos;
+		openfpm::vector<openfpm::vector<Point<dim, St>,Memory,layout_base,openfpm::grow_policy_identity>> m_pos(prc_r.size());
 		//! properties vector
-		openfpm::vector<openfpm::vector<prop,Memory,layout_base,openfpm::grow_policy_identity>> m_prp;
+		openfpm::vector<openfpm::vector<prop,Memory,layout_base,openfpm::grow_policy_identity>> m_prp(prc_r.size());
+		// Fill the ghost part of the messages (before the migrating particles are removed)
+		for (size_t i = 0 ; i < prc_r.size() ; i++)
+		{
+			auto & lbl = g_lbl.get(prc_r.get(i));
+			size_t n_mig = prc_sz_r.get(i);
 
-		fill_send_map_buf(v_pos,v_prp, prc_sz_r,prc_r, m_pos, m_prp,prc_sz,opt);
+			// the last position element store the number of migrating particles
+			m_pos.get(i).resize(n_mig + lbl.size() + 1);
+			m_prp.get(i).resize(n_mig + lbl.size());
+			m_pos.get(i).set(n_mig + lbl.size(), mig_count_encode(n_mig));
 
-		size_t opt_ = 0;
-		if (opt & RUN_ON_DEVICE)
+			for (size_t j = 0 ; j < lbl.size() ; j++)
+			{
+				Point<dim, St> s = v_pos.get(lbl.get(j).template get<0>());
+				s -= shifts.get(lbl.get(j).template get<1>());
+				m_pos.get(i).set(n_mig + j, s);
+				m_prp.get(i).set(n_mig + j, v_prp.get(lbl.get(j).template get<0>()));
+			}
+		}
+
+		// Migrating particles that this processor has in its own ghost
+		openfpm::vector<Point<dim, St>,Memory,layout_base> lg_pos;
+		openfpm::vector<prop,Memory,layout_base> lg_prp;
+
+		auto & lbl_l = g_lbl.get(rank);
+		for (size_t j = 0 ; j < lbl_l.size() ; j++)
 		{
-#if defined(CUDA_GPU) && defined(__NVCC__)
-			// Before doing the communication on RUN_ON_DEVICE we have to be sure that the previous kernels complete
-			cudaDeviceSynchronize();
-			opt_ |= MPI_GPU_DIRECT;
-#else
-			std::cout << __FILE__ << ":" << __LINE__ << " error: to use the option RUN_ON_DEVICE you must compile with NVCC" << std::endl;
-#endif
+			Point<dim, St> s = v_pos.get(lbl_l.get(j).template get<0>());
+			s -= shifts.get(lbl_l.get(j).template get<1>());
+			lg_pos.add(s);
+			lg_prp.add(v_prp.get(lbl_l.get(j).template get<0>()));
+		}
+
+		// Fill the migrating part of the messages and remove the migrating particles
+		openfpm::vector<size_t> cnt(prc_r.size());
+
+		for (size_t i = 0; i < prc_r.size() ; i++)
+		{cnt.get(i) = 0;}
+
+		long int id_end = v_pos.size();
+		long int end = m_opart.size()-1;
+
+		for (size_t i = 0; i < m_opart.size(); i++)
+		{
+			process_map_particle<proc_without_prp>(i,end,id_end,m_opart,p_map_req,m_pos,m_prp,v_pos,v_prp,cnt);
 		}
 
+		v_pos.resize(v_pos.size() - m_opart.size());
+		v_prp.resize(v_prp.size() - m_opart.size());
+
+		openfpm::vector<Point<dim, St>,Memory,layout_base> r_pos;
+		openfpm::vector<prop,Memory,layout_base> r_prp;
+
 		v_cl.template SSendRecv<openfpm::vector<Point<dim, St>,Memory,layout_base,openfpm::grow_policy_identity>,
 					   openfpm::vector<Point<dim, St>,Memory,layout_base>,
 					   layout_base>
-					   (m_pos,v_pos,prc_r,prc_recv_map,recv_sz_map,opt_);
+					   (m_pos,r_pos,prc_r,prc_recv_map,recv_sz_map,0);
 
 		v_cl.template SSendRecv<openfpm::vector<prop,Memory,layout_base,openfpm::grow_policy_identity>,
 					   openfpm::vector<prop,Memory,layout_base>,
 					   layout_base>
-					   (m_prp,v_prp,prc_r,prc_recv_map,recv_sz_map,opt_);
+					   (m_prp,r_prp,prc_r,prc_recv_map_prp,recv_sz_map_prp,0);
 
-		// mark the ghost part
+		// Append first the particles that migrated here ...
+		size_t off_pos = 0;
+		size_t off_prp = 0;
+		for (size_t i = 0 ; i < recv_sz_map_prp.size() ; i++)
+		{
+			size_t n_mig = mig_count_decode(r_pos.get(off_pos + recv_sz_map.get(i) - 1));
+
+			for (size_t j = 0 ; j < n_mig ; j++)
+			{
+				v_pos.add(r_pos.get(off_pos + j));
+				v_prp.add(r_prp.get(off_prp + j));
+			}
+
+			off_pos += recv_sz_map.get(i);
+			off_prp += recv_sz_map_prp.get(i);
+		}
 
 		g_m = v_pos.size();
+
+		// ... then the ghost particles
+		for (size_t j = 0 ; j < lg_pos.size() ; j++)
+		{
+			v_pos.add(lg_pos.get(j));
+			v_prp.add(lg_prp.get(j));
+		}
+
+		off_pos = 0;
+		off_prp = 0;
+		for (size_t i = 0 ; i < recv_sz_map_prp.size() ; i++)
+		{
+			size_t n_mig = mig_count_decode(r_pos.get(off_pos + recv_sz_map.get(i) - 1));
+
+			for (size_t j = n_mig ; j < recv_sz_map_prp.get(i) ; j++)
+			{
+				v_pos.add(r_pos.get(off_pos + j));
+				v_prp.add(r_prp.get(off_prp + j));
+			}
+
+			off_pos += recv_sz_map.get(i);
+			off_prp += recv_sz_map_prp.get(i);
+		}
+
+		// local ghost particles coming from the periodicity of the domain
+		add_loc_particles_bc(v_pos,v_prp,g_m,opt & ~SKIP_LABELLING);
 	}
 
 	/*! \brief Get the decomposition
@@ -2135,6 +3855,13 @@ public:
 	{
 		dec = vc.dec;
 
+		// the decomposition changed, the sub-domains of the lazy map must be collected again
+		lazy_cl_ndec = -1;
+		lazy_valid = false;
+
+		// and the skin cells computed again
+		skin_ndec = -1;
+
 		return *this;
 	}
 
@@ -2149,9 +3876,51 @@ public:
 	{
 		dec = vc.dec;
 
+		// the decomposition changed, the sub-domains of the lazy map must be collected again
+		lazy_cl_ndec = -1;
+		lazy_valid = false;
+
+		// and the skin cells computed again
+		skin_ndec = -1;
+
 		return *this;
 	}
 
+	/*! \brief Merge the local replicated particles (periodic ghost of the local processor) into the local particles
+	 *
+	 * \tparam op which kind of operation to apply
+	 * \tparam prp list of properties to merge
+	 *
+	 * \param v_prp vector od particle properties
+	 * \param opt options
+	 *
+	 */
+	template<template<typename,typename> class op, int ... prp>
+	void ghost_put_local_(openfpm::vector<prop,Memory,layout_base> & v_prp, size_t opt)
+	{
+		if (lg_m < v_prp.size() && v_prp.size() - lg_m != o_part_loc.size())
+		{
+			std::cerr << "Error: " << __FILE__ << ":" << __LINE__ << " Local ghost particles = " << v_prp.size() - lg_m << " != " << o_part_loc.size() << std::endl;
+			std::cerr << "Error: " << __FILE__ << ":" << __LINE__ << " Check that you did a ghost_get before a ghost_put" << std::endl;
+		}
+
+
+		if (opt & RUN_ON_DEVICE)
+		{
+			v_prp.template merge_prp_v_device<op,prop,Memory,
+											  openfpm::grow_policy_double,
+											  layout_base,
+											  decltype(o_part_loc),prp ...>(v_prp,lg_m,o_part_loc);
+		}
+		else
+		{
+			v_prp.template merge_prp_v<op,prop,Memory,
+			                           openfpm::grow_policy_double,
+									   layout_base,
+									   decltype(o_part_loc),prp ...>(v_prp,lg_m,o_part_loc);
+		}
+	}
+
 	/*! \brief Ghost put
 	 *
 	 * \tparam op operation to apply
@@ -2176,7 +3945,7 @@ public:
 		typedef openfpm::vector<prp_object,Memory,layout_base> send_vector;
 
 		openfpm::vector<send_vector> g_send_prp;
-		fill_send_ghost_put_prp_buf<send_vector, prp_object, prp...>(v_prp,g_send_prp,g_m,opt);
+		fill_send_ghost_put_prp_buf<send_vector, prp_object, prp...>(v_prp,g_send_prp,g_m,opt,hsmem);
 
 		if (opt & RUN_ON_DEVICE)
 		{
@@ -2237,28 +4006,187 @@ public:
 		}
 
 		// process also the local replicated particles
+		ghost_put_local_<op,prp...>(v_prp,opt);
 
-		if (lg_m < v_prp.size() && v_prp.size() - lg_m != o_part_loc.size())
+		// the local particles received the contributions of the ghost
+		prp_dirty |= prp_mask<prp...>();
+	}
+
+	/*! \brief It start to merge the ghost particles properties back to the real particles without waiting
+	 *
+	 * The ghost contributions are packed and sent, the local replicated particles are merged immediately.
+	 * The contributions of the other processors are merged with op by ghost_put_wait_ as they arrive. Until
+	 * then the properties prp of the real particles that are ghost on other processors must not be used,
+	 * while the ghost particles can be overwritten
+	 *
+	 * \tparam op which kind of operation to apply
+	 * \tparam prp list of properties to merge
+	 *
+	 * \param v_pos vector of particle positions
+	 * \param v_prp vector od particle properties
+	 * \param g_m ghost marker
+	 * \param opt options
+	 *
+	 */
+	template<template<typename,typename> class op, int ... prp>
+	void Ighost_put_(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
+					 openfpm::vector<prop,Memory,layout_base> & v_prp,
+					 size_t & g_m,
+					 size_t opt)
+	{
+		// Sending property object
+		typedef object<typename object_creator<typename prop::type, prp...>::type> prp_object;
+
+		// send vector for each processor
+		typedef openfpm::vector<prp_object,Memory,layout_base> send_vector;
+
+		openfpm::vector<send_vector> g_send_prp;
+		fill_send_ghost_put_prp_buf<send_vector, prp_object, prp...>(v_prp,g_send_prp,g_m,opt,hsmem_put);
+
+		// the merge happen in ghost_put_wait_, the labelling can be changed by a ghost_get in the meanwhile
+		gp_opart = g_opart;
+		gp_prc_g_opart = prc_g_opart;
+		gp_opart_sz = g_opart_sz;
+		if (opt & NO_CHANGE_ELEMENTS)
+		{gp_prc_recv = prc_recv_get_prp;}
+		else
+		{gp_prc_recv = get_last_ghost_get_num_proc_vector();}
+		gp_in_flight = true;
+
+		if (opt & RUN_ON_DEVICE)
 		{
-			std::cerr << "Error: " << __FILE__ << ":" << __LINE__ << " Local ghost particles = " << v_prp.size() - lg_m << " != " << o_part_loc.size() << std::endl;
-			std::cerr << "Error: " << __FILE__ << ":" << __LINE__ << " Check that you did a ghost_get before a ghost_put" << std::endl;
+#if defined(CUDA_GPU) && defined(__NVCC__)
+			// Before doing the communication on RUN_ON_DEVICE we have to be sure that the previous kernels complete
+			cudaDeviceSynchronize();
+#else
+			std::cout << __FILE__ << ":" << __LINE__ << " error: to use the option RUN_ON_DEVICE you must compile with NVCC" << std::endl;
+#endif
 		}
 
+		size_t opt_ = compute_options(opt);
 
-		if (opt & RUN_ON_DEVICE)
+		// Send and receive ghost particle information
+		if (opt & NO_CHANGE_ELEMENTS)
 		{
-			v_prp.template merge_prp_v_device<op,prop,Memory,
-											  openfpm::grow_policy_double,
-											  layout_base,
-											  decltype(o_part_loc),prp ...>(v_prp,lg_m,o_part_loc);
+			if (opt & RUN_ON_DEVICE)
+			{
+				op_ssend_recv_merge_gpu<op,decltype(g_opart_device),decltype(prc_offset)> opm(g_opart_device,prc_offset);
+				v_cl.template SSendRecvP_opAsync<op_ssend_recv_merge_gpu<op,decltype(g_opart_device),decltype(prc_offset)>,
+				                                 send_vector,
+				                                 decltype(v_prp),
+				                                 layout_base,
+				                                 prp...>(g_send_prp,v_prp,gp_prc_recv,opm,gp_prc_g_opart,gp_opart_sz,opt_);
+			}
+			else
+			{
+				op_ssend_recv_merge<op,decltype(gp_opart)> opm(gp_opart);
+				v_cl.template SSendRecvP_opAsync<op_ssend_recv_merge<op,decltype(gp_opart)>,
+				                                 send_vector,
+				                                 decltype(v_prp),
+				                                 layout_base,
+				                                 prp...>(g_send_prp,v_prp,gp_prc_recv,opm,gp_prc_g_opart,gp_opart_sz,opt_);
+			}
 		}
 		else
 		{
-			v_prp.template merge_prp_v<op,prop,Memory,
-			                           openfpm::grow_policy_double,
-									   layout_base,
-									   decltype(o_part_loc),prp ...>(v_prp,lg_m,o_part_loc);
+			if (opt & RUN_ON_DEVICE)
+			{
+				op_ssend_recv_merge_gpu<op,decltype(g_opart_device),decltype(prc_offset)> opm(g_opart_device,prc_offset);
+				v_cl.template SSendRecvP_opAsync<op_ssend_recv_merge_gpu<op,decltype(g_opart_device),decltype(prc_offset)>,
+				                                 send_vector,
+				                                 decltype(v_prp),
+				                                 layout_base,
+				                                 prp...>(g_send_prp,v_prp,gp_prc_recv,opm,prc_recv_put,recv_sz_put,opt_);
+			}
+			else
+			{
+				op_ssend_recv_merge<op,decltype(gp_opart)> opm(gp_opart);
+				v_cl.template SSendRecvP_opAsync<op_ssend_recv_merge<op,decltype(gp_opart)>,
+				                                 send_vector,
+				                                 decltype(v_prp),
+				                                 layout_base,
+				                                 prp...>(g_send_prp,v_prp,gp_prc_recv,opm,prc_recv_put,recv_sz_put,opt_);
+			}
+		}
+
+		// the local replicated particles does not need communication
+		ghost_put_local_<op,prp...>(v_prp,opt);
+	}
+
+	/*! \brief It wait the completion of a ghost_put started with Ighost_put_, merging the incoming contributions
+	 *
+	 * \tparam op which kind of operation to apply (must be the same of Ighost_put_)
+	 * \tparam prp list of properties to merge (must be the same of Ighost_put_)
+	 *
+	 * \param v_pos vector of particle positions
+	 * \param v_prp vector od particle properties
+	 * \param g_m ghost marker
+	 * \param opt options (must be the same of Ighost_put_)
+	 *
+	 */
+	template<template<typename,typename> class op, int ... prp>
+	void ghost_put_wait_(openfpm::vector<Point<dim, St>,Memory,layout_base> & v_pos,
+						 openfpm::vector<prop,Memory,layout_base> & v_prp,
+						 size_t & g_m,
+						 size_t opt)
+	{
+		// Sending property object
+		typedef object<typename object_creator<typename prop::type, prp...>::type> prp_object;
+
+		// send vector for each processor
+		typedef openfpm::vector<prp_object,Memory,layout_base> send_vector;
+
+		openfpm::vector<send_vector> g_send_prp;
+
+		size_t opt_ = compute_options(opt);
+
+		if (opt & NO_CHANGE_ELEMENTS)
+		{
+			if (opt & RUN_ON_DEVICE)
+			{
+				op_ssend_recv_merge_gpu<op,decltype(g_opart_device),decltype(prc_offset)> opm(g_opart_device,prc_offset);
+				v_cl.template SSendRecvP_opWait<op_ssend_recv_merge_gpu<op,decltype(g_opart_device),decltype(prc_offset)>,
+				                                send_vector,
+				                                decltype(v_prp),
+				                                layout_base,
+				                                prp...>(g_send_prp,v_prp,gp_prc_recv,opm,gp_prc_g_opart,gp_opart_sz,opt_);
+			}
+			else
+			{
+				op_ssend_recv_merge<op,decltype(gp_opart)> opm(gp_opart);
+				v_cl.template SSendRecvP_opWait<op_ssend_recv_merge<op,decltype(gp_opart)>,
+				                                send_vector,
+				                                decltype(v_prp),
+				                                layout_base,
+				                                prp...>(g_send_prp,v_prp,gp_prc_recv,opm,gp_prc_g_opart,gp_opart_sz,opt_);
+			}
+		}
+		else
+		{
+			if (opt & RUN_ON_DEVICE)
+			{
+				op_ssend_recv_merge_gpu<op,decltype(g_opart_device),decltype(prc_offset)> opm(g_opart_device,prc_offset);
+				v_cl.template SSendRecvP_opWait<op_ssend_recv_merge_gpu<op,decltype(g_opart_device),decltype(prc_offset)>,
+				                                send_vector,
+				                                decltype(v_prp),
+				                                layout_base,
+				                                prp...>(g_send_prp,v_prp,gp_prc_recv,opm,prc_recv_put,recv_sz_put,opt_);
+			}
+			else
+			{
+				op_ssend_recv_merge<op,decltype(gp_opart)> opm(gp_opart);
+				v_cl.template SSendRecvP_opWait<op_ssend_recv_merge<op,decltype(gp_opart)>,
+				                                send_vector,
+				                                decltype(v_prp),
+				                                layout_base,
+				                                prp...>(g_send_prp,v_prp,gp_prc_recv,opm,prc_recv_put,recv_sz_put,opt_);
+			}
 		}
+
+		gp_in_flight = false;
+
+		// the local particles received the contributions of the ghost
+		prp_dirty |= prp_mask<prp...>();
 	}
 };
 